@@ -0,0 +1,525 @@
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "CSGBenchmark.h"
+#include "FileManager.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+using namespace enterprise_manager;
+
+CSGBenchmark::CSGBenchmark(void)
+	: _minimumNanoseconds(2e8) {}
+
+
+CSGBenchmark::~CSGBenchmark(void) {}
+
+void CSGBenchmark::Run() {
+	printf("%-20s %-14s %9s %14s %14s %10s\n", "benchmark", "operation", "polygons", "ns/op", "polygons/s", "peak MB");
+	SphereBenchmark();
+	CylinderBenchmark();
+	WallBenchmark();
+	ConvexBenchmark();
+	UnionBenchmark();
+	SeparationBenchmark();
+	FileBenchmark();
+}
+
+void CSGBenchmark::SphereBenchmark() {
+	for (Ouint slices = 8; slices <= 64; slices *= 2) {
+		MeshData sphereA = _Sphere(Vec3d(0, 0, 0), 1, slices, slices / 2);
+		MeshData sphereB = _Sphere(Vec3d(0.3, 0.2, 0.1), 1, slices, slices / 2);
+		_RunPair("sphere " + to_string(slices), sphereA, sphereB);
+	}
+}
+
+void CSGBenchmark::CylinderBenchmark() {
+	for (Ouint segments = 8; segments <= 128; segments *= 2) {
+		MeshData cylinderA = _Cylinder(Vec3d(0, 0, 0), 0.5, 3, segments, false);
+		MeshData cylinderB = _Cylinder(Vec3d(0, 0.1, 0), 0.4, 3, segments, true);
+		_RunPair("cylinder " + to_string(segments), cylinderA, cylinderB);
+	}
+}
+
+void CSGBenchmark::WallBenchmark() {
+	for (Ouint openings = 1; openings <= 64; openings *= 2) {
+		Odouble thickness = 0.3;
+		MeshData wall = _Box(Vec3d(0, 0, 0), Vec3d(openings + 0.5, thickness, 3));
+		vector<MeshData> opening;
+		Ouint polygons = wall.polygonCount();
+		for (Ouint i = 0; i < openings; ++i) {
+			opening.push_back(_Box(Vec3d(i + 0.5, -0.1, 0.5), Vec3d(i + 1, thickness + 0.1, 2)));
+			polygons += opening.back().polygonCount();
+		}
+
+		//one opening after another grows much faster than linear, leave out the large walls
+		Odouble total = 0;
+		Ouint iterations = 0;
+		while (openings <= 16 && total < _minimumNanoseconds) {
+			Object<Odouble>* result = wall.CreateObject();
+			vector<Object<Odouble>*> cutter;
+			for (Ouint i = 0; i < openings; ++i)
+				cutter.push_back(opening[i].CreateObject());
+
+			chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+			for (Ouint i = 0; i < openings; ++i)
+				Object<Odouble>::CreateDifference(*result, *cutter[i]);
+			total += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+			++iterations;
+
+			for (Ouint i = 0; i < openings; ++i)
+				delete cutter[i];
+			delete result;
+		}
+		if (iterations > 0)
+			_Print("wall " + to_string(openings), "difference", polygons, total / iterations);
+
+		//the same with all openings subtracted together
+		total = 0;
+		iterations = 0;
+		while (total < _minimumNanoseconds) {
+			Object<Odouble>* result = wall.CreateObject();
+			vector<Object<Odouble>*> cutter;
+			for (Ouint i = 0; i < openings; ++i)
+				cutter.push_back(opening[i].CreateObject());
+
+			chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+			Object<Odouble>::CreateDifference(*result, cutter);
+			total += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+			++iterations;
+
+			for (Ouint i = 0; i < openings; ++i)
+				delete cutter[i];
+			delete result;
+		}
+		_Print("wall " + to_string(openings), "difference all", polygons, total / iterations);
+	}
+}
+
+void CSGBenchmark::UnionBenchmark() {
+	for (Ouint rows = 2; rows <= 16; rows *= 2) {
+		//every box overlaps the next one in its row, the rows are apart
+		vector<MeshData> box;
+		Ouint polygons = 0;
+		for (Ouint row = 0; row < rows; ++row) {
+			for (Ouint i = 0; i < rows; ++i) {
+				box.push_back(_Box(Vec3d(i, 2.0 * row, 0), Vec3d(i + 1.5, 2.0 * row + 1, 1 + 0.01 * i)));
+				polygons += box.back().polygonCount();
+			}
+		}
+		string name = "union " + to_string(box.size());
+
+		//one box after another grows much faster than linear, leave out the large sets
+		Odouble total = 0;
+		Ouint iterations = 0;
+		while (box.size() <= 64 && total < _minimumNanoseconds) {
+			vector<Object<Odouble>*> objects;
+			for (Ouint i = 0; i < box.size(); ++i)
+				objects.push_back(box[i].CreateObject());
+
+			chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+			for (Ouint i = 1; i < objects.size(); ++i)
+				Object<Odouble>::CreateUnion(*objects[0], *objects[i]);
+			total += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+			++iterations;
+
+			for (Ouint i = 0; i < objects.size(); ++i)
+				delete objects[i];
+		}
+		if (iterations > 0)
+			_Print(name, "union", polygons, total / iterations);
+
+		//the same as a tree, on one thread and on all of them
+		Ouint threadCounts[] = { 1, thread::hardware_concurrency() };
+		for (Ouint t = 0; t < 2 && (t == 0 || threadCounts[t] > 1); ++t) {
+			total = 0;
+			iterations = 0;
+			while (total < _minimumNanoseconds) {
+				vector<Object<Odouble>*> objects;
+				for (Ouint i = 0; i < box.size(); ++i)
+					objects.push_back(box[i].CreateObject());
+
+				Context<Odouble> context;
+				context.threadCount = threadCounts[t];
+				chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+				Object<Odouble>* result = Object<Odouble>::Union(objects, context);
+				total += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+				++iterations;
+
+				delete result;
+				for (Ouint i = 0; i < objects.size(); ++i)
+					delete objects[i];
+			}
+			_Print(name, "union all " + to_string(threadCounts[t]), polygons, total / iterations);
+		}
+	}
+}
+
+void CSGBenchmark::SeparationBenchmark() {
+	printf("\n%-20s %9s %9s %8s %14s %14s\n", "benchmark", "pairs", "separated", "rate", "separate/s", "intersect/s");
+	for (Ouint slices = 8; slices <= 64; slices *= 2) {
+		MeshData sphereA = _Sphere(Vec3d(0, 0, 0), 1, slices, slices / 2);
+		MeshData sphereB = _Sphere(Vec3d(0.3, 0.2, 0.1), 1, slices, slices / 2);
+		Object<Odouble>* objectA = sphereA.CreateObject();
+		Object<Odouble>* objectB = sphereB.CreateObject();
+		Context<Odouble> context;
+		ContextScope<Odouble> scope(context);
+		Object<Odouble>::SetTolerance(*objectA, *objectB);
+
+		//the candidates of each polygon of A as SplitBy finds them, the polygons of B whose extents overlap
+		const vector<Polygon<Odouble>*>& polygonA = objectA->polygon();
+		const vector<Polygon<Odouble>*>& polygonB = objectB->polygon();
+		vector<Vec3d> minA, maxA, minB, maxB;
+		_PolygonExtents(polygonA, minA, maxA);
+		_PolygonExtents(polygonB, minB, maxB);
+		PlaneTable<Odouble> planesB;
+		planesB.Build(polygonB);
+		vector<vector<Oint> > candidates(polygonA.size());
+		Ouint64 pairs = 0;
+		for (Ouint i = 0; i < polygonA.size(); ++i) {
+			for (Ouint k = 0; k < polygonB.size(); ++k) {
+				Obool overlap = true;
+				for (Oint axis = 0; axis < 3; ++axis)
+					overlap = overlap && minA[i][axis] <= maxB[k][axis] && minB[k][axis] <= maxA[i][axis];
+				if (overlap)
+					candidates[i].push_back(k);
+			}
+			pairs += candidates[i].size();
+		}
+
+		Odouble separateTotal = 0;
+		Ouint separateIterations = 0;
+		Ouint64 separated = 0;
+		vector<Oint> kept;
+		while (separateTotal < _minimumNanoseconds) {
+			separated = 0;
+			chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+			for (Ouint i = 0; i < candidates.size(); ++i) {
+				kept = candidates[i];
+				separated += planesB.RejectSeparated(*polygonA[i], context.tolerance, kept);
+			}
+			separateTotal += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+			++separateIterations;
+		}
+
+		Odouble intersectTotal = 0;
+		Ouint intersectIterations = 0;
+		while (intersectTotal < _minimumNanoseconds) {
+			chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+			for (Ouint i = 0; i < candidates.size(); ++i) {
+				for (Ouint k = 0; k < candidates[i].size(); ++k) {
+					Segment<Odouble> segmentA, segmentB;
+					Polygon<Odouble>::Intersect(*polygonA[i], *polygonB[candidates[i][k]], segmentA, segmentB);
+				}
+			}
+			intersectTotal += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+			++intersectIterations;
+		}
+
+		printf("%-20s %9llu %9llu %7.1f%% %14.0f %14.0f\n", ("sphere " + to_string(slices)).c_str(), pairs, separated,
+			pairs > 0 ? 100.0 * separated / pairs : 0.0,
+			separateTotal > 0 ? pairs * 1e9 * separateIterations / separateTotal : 0.0,
+			intersectTotal > 0 ? pairs * 1e9 * intersectIterations / intersectTotal : 0.0);
+		delete objectA;
+		delete objectB;
+	}
+}
+
+void CSGBenchmark::FileBenchmark() {
+	printf("\n%-20s %-10s %9s %10s %12s %12s %12s\n", "benchmark", "format", "polygons", "MB", "write MB/s", "read MB/s", "polygons/s");
+	FileManager files;
+	const string path = "benchmark.file";
+	//the binary file, the text file read on one thread and on all of them
+	const Ouint formatCount = 3;
+	const string formatNames[formatCount] = { "binary", "text", "text" };
+	Ouint threadCounts[formatCount] = { 1, 1, thread::hardware_concurrency() };
+	for (Ouint slices = 64; slices <= 256; slices *= 4) {
+		//several spheres, so the objects of the text file can be parsed in parallel
+		vector<Object<Odouble>*> objects;
+		Ouint polygons = 0;
+		for (Ouint i = 0; i < 8; ++i) {
+			objects.push_back(_Sphere(Vec3d(3.0 * i, 0, 0), 1, slices, slices / 2).CreateObject());
+			polygons += (Ouint)objects.back()->polygon().size();
+		}
+
+		for (Ouint format = 0; format < formatCount; ++format) {
+			if (format == 2 && threadCounts[format] <= 1)
+				continue;
+
+			Odouble writeTotal = 0;
+			Ouint writeIterations = 0;
+			while (writeTotal < _minimumNanoseconds) {
+				chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+				if (format == 0)
+					files.WriteBinaryFile(objects, path);
+				else
+					files.WriteTestFile(objects, path);
+				writeTotal += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+				++writeIterations;
+			}
+
+			Context<Odouble> context;
+			context.threadCount = threadCounts[format];
+			ContextScope<Odouble> scope(context);
+			Odouble readTotal = 0;
+			Ouint readIterations = 0;
+			while (readTotal < _minimumNanoseconds) {
+				vector<Object<Odouble>*> read;
+				chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+				if (format == 0)
+					files.ReadBinaryFile(path, read);
+				else
+					files.ReadTestFile(path, read);
+				readTotal += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+				++readIterations;
+				files.ClearObjects(read);
+			}
+
+			ifstream file(path.c_str(), ios::in | ios::binary | ios::ate);
+			Odouble megabytes = (Odouble)file.tellg() / (1024.0 * 1024.0);
+			file.close();
+			printf("%-20s %-10s %9u %10.2f %12.0f %12.0f %12.0f\n", ("spheres 8x" + to_string(slices)).c_str(), (formatNames[format] + " " + to_string(threadCounts[format])).c_str(),
+				polygons, megabytes, megabytes * 1e9 * writeIterations / writeTotal, megabytes * 1e9 * readIterations / readTotal, polygons * 1e9 * readIterations / readTotal);
+		}
+		files.ClearObjects(objects);
+	}
+	remove(path.c_str());
+}
+
+void CSGBenchmark::ConvexBenchmark() {
+	//fixed seed, so every run measures the same polyhedra
+	mt19937 random(1);
+	for (Ouint slices = 8; slices <= 64; slices *= 2) {
+		MeshData convexA = _RandomConvex(random, Vec3d(0, 0, 0), 1, slices, slices / 2);
+		MeshData convexB = _RandomConvex(random, Vec3d(0.25, 0.15, 0.1), 1, slices, slices / 2);
+		_RunPair("convex " + to_string(slices), convexA, convexB);
+	}
+}
+
+Oint CSGBenchmark::MeshData::AddPoint(const Vec3d& point) {
+	coord.push_back(point);
+	return (Oint)coord.size() - 1;
+}
+
+void CSGBenchmark::MeshData::AddFace(const vector<Oint>& face, const Vec3d& interior) {
+	//Newell's method, the face may have more than three vertices
+	Vec3d normal(0, 0, 0);
+	for (Ouint i = 0; i < face.size(); ++i) {
+		const Vec3d& current = coord[face[i]];
+		const Vec3d& next = coord[face[(i + 1) % face.size()]];
+		normal += current.Cross(next);
+	}
+	Obool outward = normal * (coord[face[0]] - interior) > 0;
+	for (Ouint i = 0; i < face.size(); ++i)
+		coordIndex.push_back(outward ? face[i] : face[face.size() - 1 - i]);
+	coordIndex.push_back(-1);
+}
+
+Ouint CSGBenchmark::MeshData::polygonCount() const {
+	Ouint count = 0;
+	for (Ouint i = 0; i < coordIndex.size(); ++i) {
+		if (coordIndex[i] == -1)
+			++count;
+	}
+	return count;
+}
+
+Object<Odouble>* CSGBenchmark::MeshData::CreateObject() const {
+	return Object<Odouble>::CreateFromIndexedFaceSet(coord, coordIndex, true, true);
+}
+
+/* static */ void CSGBenchmark::_PolygonExtents(const vector<Polygon<Odouble>*>& polygons, vector<Vec3d>& min, vector<Vec3d>& max) {
+	min.resize(polygons.size());
+	max.resize(polygons.size());
+	for (Ouint i = 0; i < polygons.size(); ++i) {
+		const vector<Vertex<Odouble>*>& vertex = polygons[i]->vertex();
+		min[i] = max[i] = vertex[0]->point();
+		for (Ouint j = 1; j < vertex.size(); ++j) {
+			min[i].MinComp(vertex[j]->point());
+			max[i].MaxComp(vertex[j]->point());
+		}
+	}
+}
+
+CSGBenchmark::MeshData CSGBenchmark::_Sphere(const Vec3d& center, Odouble radius, Ouint slices, Ouint stacks) {
+	MeshData mesh;
+	Oint north = mesh.AddPoint(center + Vec3d(0, 0, radius));
+	for (Ouint stack = 1; stack < stacks; ++stack) {
+		Odouble theta = PI * stack / stacks;
+		for (Ouint slice = 0; slice < slices; ++slice) {
+			Odouble phi = 2 * PI * slice / slices;
+			mesh.AddPoint(center + Vec3d(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)) * radius);
+		}
+	}
+	Oint south = mesh.AddPoint(center - Vec3d(0, 0, radius));
+
+	//ring r starts at 1 + r * slices
+	for (Ouint slice = 0; slice < slices; ++slice) {
+		Oint next = (slice + 1) % slices;
+		mesh.AddFace({ north, 1 + (Oint)slice, 1 + next }, center);
+		for (Ouint ring = 0; ring + 2 < stacks; ++ring) {
+			Oint upper = 1 + ring * slices;
+			Oint lower = upper + slices;
+			mesh.AddFace({ upper + (Oint)slice, lower + (Oint)slice, lower + next }, center);
+			mesh.AddFace({ upper + (Oint)slice, lower + next, upper + next }, center);
+		}
+		Oint last = 1 + (stacks - 2) * slices;
+		mesh.AddFace({ south, last + next, last + (Oint)slice }, center);
+	}
+	return mesh;
+}
+
+CSGBenchmark::MeshData CSGBenchmark::_Cylinder(const Vec3d& center, Odouble radius, Odouble height, Ouint segments, Obool alongX) {
+	MeshData mesh;
+	for (Ouint end = 0; end < 2; ++end) {
+		Odouble axis = (end == 0 ? -0.5 : 0.5) * height;
+		for (Ouint segment = 0; segment < segments; ++segment) {
+			Odouble phi = 2 * PI * segment / segments;
+			Vec3d offset = alongX
+				? Vec3d(axis, radius * sin(phi), radius * cos(phi))
+				: Vec3d(radius * cos(phi), radius * sin(phi), axis);
+			mesh.AddPoint(center + offset);
+		}
+	}
+
+	vector<Oint> bottom, top;
+	for (Ouint segment = 0; segment < segments; ++segment) {
+		Oint next = (segment + 1) % segments;
+		mesh.AddFace({ (Oint)segment, next, (Oint)segments + next, (Oint)(segments + segment) }, center);
+		bottom.push_back(segment);
+		top.push_back(segments + segment);
+	}
+	mesh.AddFace(bottom, center);
+	mesh.AddFace(top, center);
+	return mesh;
+}
+
+CSGBenchmark::MeshData CSGBenchmark::_Box(const Vec3d& min, const Vec3d& max) {
+	MeshData mesh;
+	for (Ouint i = 0; i < 8; ++i) {
+		mesh.AddPoint(Vec3d((i & 1) ? max[0] : min[0], (i & 2) ? max[1] : min[1], (i & 4) ? max[2] : min[2]));
+	}
+	Vec3d center = (min + max) * 0.5;
+	mesh.AddFace({ 0, 2, 3, 1 }, center);
+	mesh.AddFace({ 4, 5, 7, 6 }, center);
+	mesh.AddFace({ 0, 1, 5, 4 }, center);
+	mesh.AddFace({ 2, 6, 7, 3 }, center);
+	mesh.AddFace({ 0, 4, 6, 2 }, center);
+	mesh.AddFace({ 1, 3, 7, 5 }, center);
+	return mesh;
+}
+
+CSGBenchmark::MeshData CSGBenchmark::_RandomConvex(mt19937& random, const Vec3d& center, Odouble radius, Ouint slices, Ouint stacks) {
+	//scaling and rotating a sphere keeps it convex and its faces planar
+	uniform_real_distribution<Odouble> scale(0.6, 1.4);
+	uniform_real_distribution<Odouble> angle(0, 2 * PI);
+	Vec3d axisScale(scale(random), scale(random), scale(random));
+	Odouble alpha = angle(random);
+	Odouble beta = angle(random);
+
+	MeshData mesh = _Sphere(Vec3d(0, 0, 0), radius, slices, stacks);
+	for (Ouint i = 0; i < mesh.coord.size(); ++i) {
+		Vec3d p = mesh.coord[i];
+		p = Vec3d(p[0] * axisScale[0], p[1] * axisScale[1], p[2] * axisScale[2]);
+		p = Vec3d(p[0] * cos(alpha) - p[1] * sin(alpha), p[0] * sin(alpha) + p[1] * cos(alpha), p[2]);
+		p = Vec3d(p[0], p[1] * cos(beta) - p[2] * sin(beta), p[1] * sin(beta) + p[2] * cos(beta));
+		mesh.coord[i] = center + p;
+	}
+	return mesh;
+}
+
+void CSGBenchmark::_RunPair(const string& name, const MeshData& meshA, const MeshData& meshB) {
+	static const char* operationName[OPERATION_COUNT] = { "union", "intersection", "difference", "split", "subdivide", "union arranged" };
+	Ouint polygons = meshA.polygonCount() + meshB.polygonCount();
+	Odouble nanoseconds[OPERATION_COUNT];
+	for (Oint operation = 0; operation < OPERATION_COUNT; ++operation) {
+		nanoseconds[operation] = _Time(meshA, meshB, (Operation)operation);
+		_Print(name, operationName[operation], polygons, nanoseconds[operation]);
+	}
+	//the phases of the union, timed in a separate run so the statistics do not add to the times above
+	Odouble phaseNanoseconds[Context<Odouble>::Statistics::PHASE_COUNT];
+	_Time(meshA, meshB, UNION, phaseNanoseconds);
+	for (Oint phase = 0; phase < Context<Odouble>::Statistics::PHASE_COUNT; ++phase)
+		_Print(name, Context<Odouble>::Statistics::phaseName((Context<Odouble>::Statistics::Phase)phase), polygons, phaseNanoseconds[phase]);
+}
+
+Odouble CSGBenchmark::_Time(const MeshData& meshA, const MeshData& meshB, Operation operation, Odouble* phaseNanoseconds) {
+	Context<Odouble>::Statistics statistics;
+	Odouble total = 0;
+	Ouint iterations = 0;
+	while (total < _minimumNanoseconds) {
+		//the operations change both objects, so each iteration starts from new ones
+		Object<Odouble>* objectA = meshA.CreateObject();
+		Object<Odouble>* objectB = meshB.CreateObject();
+		//the Boolean operations set the tolerances from the objects, do the same for the split alone
+		Context<Odouble> context;
+		context.detailedStatistics = phaseNanoseconds != NULL;
+		ContextScope<Odouble> scope(context);
+		if (operation == SPLIT || operation == SUBDIVIDE)
+			Object<Odouble>::SetTolerance(*objectA, *objectB);
+
+		chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+		switch (operation) {
+		case UNION:
+			Object<Odouble>::CreateUnion(*objectA, *objectB, context);
+			break;
+		case INTERSECTION:
+			Object<Odouble>::CreateIntersection(*objectA, *objectB, context);
+			break;
+		case DIFFERENCE:
+			Object<Odouble>::CreateDifference(*objectA, *objectB, context);
+			break;
+		case SPLIT:
+			objectA->SplitBy(*objectB);
+			break;
+		case SUBDIVIDE:
+			Object<Odouble>::SubdivideObjects(*objectA, *objectB);
+			break;
+		case ARRANGED_UNION:
+			context.arrangementSplit = true;
+			Object<Odouble>::CreateUnion(*objectA, *objectB, context);
+			break;
+		default:
+			break;
+		}
+		total += chrono::duration<Odouble, nano>(chrono::high_resolution_clock::now() - start).count();
+		++iterations;
+		statistics.Add(context.statistics);
+
+		delete objectA;
+		delete objectB;
+	}
+	if (phaseNanoseconds) {
+		for (Oint phase = 0; phase < Context<Odouble>::Statistics::PHASE_COUNT; ++phase)
+			phaseNanoseconds[phase] = statistics.phaseNanoseconds[phase] / iterations;
+	}
+	return total / iterations;
+}
+
+void CSGBenchmark::_Print(const string& name, const string& operation, Ouint polygons, Odouble nanoseconds) {
+	Odouble polygonsPerSecond = nanoseconds > 0 ? polygons * 1e9 / nanoseconds : 0;
+	printf("%-20s %-14s %9u %14.0f %14.0f %10.1f\n", name.c_str(), operation.c_str(), polygons, nanoseconds, polygonsPerSecond, _PeakMemory() / (1024.0 * 1024.0));
+}
+
+/* static */ Ouint64 CSGBenchmark::_PeakMemory() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (Ouint64)usage.ru_maxrss * 1024;
+#endif
+}
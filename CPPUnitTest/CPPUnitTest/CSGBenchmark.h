@@ -0,0 +1,79 @@
+#pragma once
+#include "Object.h"
+#include "config.h"
+#include <vector>
+#include <string>
+#include <random>
+
+// Times the CSG operations on generated meshes of increasing size. Run the test
+// executable with the argument "benchmark".
+class CSGBenchmark {
+public:
+	CSGBenchmark(void);
+	~CSGBenchmark(void);
+
+	// Run all benchmarks and print one line per operation and size.
+	void Run();
+
+	// Two overlapping tessellated spheres.
+	void SphereBenchmark();
+
+	// Two perpendicular cylinders.
+	void CylinderBenchmark();
+
+	// A wall from which a row of openings is subtracted one after another.
+	void WallBenchmark();
+
+	// Two overlapping random convex polyhedra.
+	void ConvexBenchmark();
+
+	// Rows of overlapping boxes united one after another and all together.
+	void UnionBenchmark();
+
+	// The polygon pairs of two spheres whose extents overlap, passed through the
+	// plane separation test of PlaneTable and through Polygon::Intersect.
+	void SeparationBenchmark();
+
+	// Spheres written to and read back from the binary and text files of FileManager.
+	void FileBenchmark();
+
+private:
+	// ARRANGED_UNION is the union with Context::arrangementSplit.
+	enum Operation { UNION, INTERSECTION, DIFFERENCE, SPLIT, SUBDIVIDE, ARRANGED_UNION, OPERATION_COUNT };
+
+	// Coordinates and face set indexes as taken by CreateFromIndexedFaceSet.
+	struct MeshData {
+		std::vector<enterprise_manager::Vec3d> coord;
+		std::vector<Oint> coordIndex;
+
+		Oint AddPoint(const enterprise_manager::Vec3d& point);
+		// Add a planar convex face, oriented so that interior is behind it.
+		void AddFace(const std::vector<Oint>& face, const enterprise_manager::Vec3d& interior);
+		Ouint polygonCount() const;
+		enterprise_manager::Object<Odouble>* CreateObject() const;
+	};
+
+	static MeshData _Sphere(const enterprise_manager::Vec3d& center, Odouble radius, Ouint slices, Ouint stacks);
+	static MeshData _Cylinder(const enterprise_manager::Vec3d& center, Odouble radius, Odouble height, Ouint segments, Obool alongX);
+	static MeshData _Box(const enterprise_manager::Vec3d& min, const enterprise_manager::Vec3d& max);
+	// A sphere with random stack and slice angles scaled along the axes. The
+	// faces stay planar and the polyhedron convex.
+	static MeshData _RandomConvex(std::mt19937& random, const enterprise_manager::Vec3d& center, Odouble radius, Ouint slices, Ouint stacks);
+
+	// The extents of the polygons from their vertices.
+	static void _PolygonExtents(const std::vector<enterprise_manager::Polygon<Odouble>*>& polygons, std::vector<enterprise_manager::Vec3d>& min, std::vector<enterprise_manager::Vec3d>& max);
+
+	// Time every operation on the pair and print the results.
+	void _RunPair(const std::string& name, const MeshData& meshA, const MeshData& meshB);
+	// Average time of the operation in nanoseconds, repeated on new objects until enough time was measured.
+	// With phaseNanoseconds the operation collects detailed statistics and the average time of each
+	// phase of Context::Statistics is stored there.
+	Odouble _Time(const MeshData& meshA, const MeshData& meshB, Operation operation, Odouble* phaseNanoseconds = NULL);
+	void _Print(const std::string& name, const std::string& operation, Ouint polygons, Odouble nanoseconds);
+
+	// Peak memory of the process in bytes.
+	static Ouint64 _PeakMemory();
+
+	// Minimum time measured per operation and size.
+	Odouble _minimumNanoseconds;
+};
@@ -1,9 +1,16 @@
 #include "CSGTest.h"
 #include "Object.h"
+#include <thread>
+#include <tuple>
+#include <mutex>
+#include <set>
+#include <fstream>
+#include <sstream>
 
 using namespace std;
 
-CSGTest::CSGTest(void) {}
+CSGTest::CSGTest(void)
+	: _failures(0) {}
 
 
 CSGTest::~CSGTest(void) {
@@ -42,6 +49,363 @@ void CSGTest::SubdivideTest() {
 	_LoadPairObjects("input/cube_pyramid_1.txt", "output/outputSubdivide2.txt", SUBDIVIDE_SECOND);
 }
 
+void CSGTest::ConcurrencyTest() {
+	//each thread runs in its own context, the results must be the same as in ToleranceTest
+	enterprise_manager::Context<Odouble> unionContext, differenceContext, intersectionContext;
+	std::thread unionThread([&]() { _LoadObjects("input/beam_cone_vertex_touch.txt", "output/outputConcurrentU.txt", UNION, unionContext); });
+	std::thread differenceThread([&]() { _LoadObjects("input/beam_cone_vertex_touch.txt", "output/outputConcurrentD.txt", DIFFERENCE, differenceContext); });
+	std::thread intersectionThread([&]() { _LoadObjects("input/beam_cone_vertex_touch.txt", "output/outputConcurrentI.txt", INTERSECTION, intersectionContext); });
+	unionThread.join();
+	differenceThread.join();
+	intersectionThread.join();
+}
+
+void CSGTest::CloneTest() {
+	//the operations on const objects leave them as they were and give the results of the operations in place
+	const Operation operations[] = { UNION, DIFFERENCE, INTERSECTION };
+	for (Operation operation : operations) {
+		vector<enterprise_manager::Object<Odouble>*> original, result;
+		parser.ReadTestFile("input/cube_pyramid_1.txt", original);
+		enterprise_manager::Context<Odouble> context;
+		_LoadObjects("input/cube_pyramid_1.txt", "", operation, context, [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+			const enterprise_manager::Object<Odouble>& objectA = *objects[0];
+			const enterprise_manager::Object<Odouble>& objectB = *objects[1];
+			if (operation == UNION)
+				result.push_back(enterprise_manager::Object<Odouble>::Union(objectA, objectB, context));
+			else if (operation == DIFFERENCE)
+				result.push_back(enterprise_manager::Object<Odouble>::Difference(objectA, objectB, context));
+			else
+				result.push_back(enterprise_manager::Object<Odouble>::Intersection(objectA, objectB, context));
+			_Check(_SameObjects(objects, original), "CloneTest(): the operands are unchanged");
+		}, [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+			_Check(result.size() == 1 && _SameObject(*result[0], *objects[0]), "CloneTest(): the result is the one of the operation in place");
+		});
+		parser.ClearObjects(result);
+		parser.ClearObjects(original);
+	}
+}
+
+void CSGTest::PlacementTest() {
+	//no polygons intersect, the results are taken from the operands
+	_LoadPairObjects("input/cube_in_cube.txt", "output/outputInsideU.txt", UNION);
+	_LoadPairObjects("input/cube_in_cube.txt", "output/outputInsideD.txt", DIFFERENCE);
+	_LoadPairObjects("input/cube_in_cube.txt", "output/outputInsideI.txt", INTERSECTION);
+	_LoadPairObjects("input/cubes.txt", "output/outputApartU.txt", UNION);
+	_LoadPairObjects("input/cubes.txt", "output/outputApartD.txt", DIFFERENCE);
+	//each object has two shells, one of the second object lies inside the first object, one outside
+	_LoadPairObjects("input/shells.txt", "output/outputShellsU.txt", UNION);
+	_LoadPairObjects("input/shells.txt", "output/outputShellsD.txt", DIFFERENCE);
+	_LoadPairObjects("input/shells.txt", "output/outputShellsI.txt", INTERSECTION);
+}
+
+void CSGTest::MultipleDifferenceTest() {
+	enterprise_manager::Context<Odouble> context;
+	//the objects are cut between the openings, the cuts must leave no vertex in the middle of an edge
+	Hook closed = [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		_Check(_IsClosed(*objects[0]), "MultipleDifferenceTest(): the result is closed");
+	};
+	//the first object is a wall, the others are its openings
+	_LoadObjects("input/wall_openings.txt", "output/outputMultipleD.txt", DIFFERENCE_ALL, context, Hook(), closed);
+	//the openings are subtracted together, one is a cavity of the first object, the other does not touch it
+	_LoadObjects("input/shell_openings.txt", "output/outputShellOpeningsD.txt", DIFFERENCE_ALL, context, Hook(), closed);
+	//the plane between the openings crosses the concave caps of the U and their convex sides
+	_LoadObjects("input/u_prism_openings.txt", "output/outputConcaveOpeningsD.txt", DIFFERENCE_ALL, context, Hook(), closed);
+}
+
+void CSGTest::MultipleUnionTest() {
+	enterprise_manager::Context<Odouble> context;
+	context.threadCount = 2;
+	//the branches take over the progress callback, the second one reports on its own thread
+	pair<mutex, set<thread::id> > progress;
+	context.progress = [](enterprise_manager::Context<Odouble>::Statistics::Phase phase, Odouble fraction, void* data) {
+		pair<mutex, set<thread::id> >& progress = *static_cast<pair<mutex, set<thread::id> >*>(data);
+		lock_guard<mutex> lock(progress.first);
+		progress.second.insert(this_thread::get_id());
+	};
+	context.progressData = &progress;
+	//two pairs of overlapping cubes, the pairs are apart
+	_LoadObjects("input/union_cubes.txt", "output/outputMultipleU.txt", UNION_ALL, context);
+	_Check(progress.second.size() == 2, "MultipleUnionTest(): the branches report progress");
+	context.progress = NULL;
+	//the first two and the last two objects are apart, the third lies inside the second
+	_LoadObjects("input/union_shells.txt", "output/outputUnionShellsU.txt", UNION_ALL, context);
+}
+
+void CSGTest::ArrangementTest() {
+	//each polygon is split by all its cuts at once, the volumes must be those of UnioinTest, DifferenceTest and IntersectionTest
+	enterprise_manager::Context<Odouble> context;
+	context.arrangementSplit = true;
+	_LoadObjects("input/cube_pyramid_1.txt", "output/outputArrangementU.txt", UNION, context);
+	_LoadObjects("input/cube_pyramid_1.txt", "output/outputArrangementD.txt", DIFFERENCE, context);
+	_LoadObjects("input/cube_pyramid_1.txt", "output/outputArrangementI.txt", INTERSECTION, context);
+	//the caps of the U prism are concave, the bar must not join its two prongs across the notch
+	_LoadObjects("input/u_prism_bar.txt", "output/outputConcaveArrangementU.txt", UNION, context);
+	_LoadObjects("input/u_prism_bar.txt", "output/outputConcaveArrangementI.txt", INTERSECTION, context);
+}
+
+void CSGTest::TransformTest() {
+	//both objects are scaled and moved before the union, the planes and extents of the polygons must follow the points
+	enterprise_manager::Matrix4<Odouble> matrix(enterprise_manager::SCALE, 2.0, 0.5, 1.0);
+	matrix *= enterprise_manager::Matrix4<Odouble>(enterprise_manager::TRANSLATE, 1.0, 2.0, 3.0);
+	enterprise_manager::Context<Odouble> context;
+	_LoadObjects("input/cube_pyramid_1.txt", "output/outputTransformU.txt", UNION, context, [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		objects[0]->Transform(matrix);
+		objects[1]->Transform(matrix);
+	});
+}
+
+void CSGTest::BinaryFileTest() {
+	//the objects and their metadata read back from a binary file must be those written
+	vector<enterprise_manager::Object<Odouble>*> objects, read;
+	parser.ReadTestFile("input/cube_pyramid_1.txt", objects);
+	vector<string> metadata, readMetadata;
+	metadata.push_back("cube");
+	metadata.push_back("pyramid");
+
+	parser.WriteBinaryFile(objects, "output/cube_pyramid_1.bin", &metadata);
+	parser.ReadBinaryFile("output/cube_pyramid_1.bin", read, &readMetadata);
+	_Check(objects.size() == 2 && _SameObjects(read, objects), "BinaryFileTest(): the objects read are those written");
+	_Check(readMetadata == metadata, "BinaryFileTest(): the metadata read is the one written");
+
+	parser.ClearObjects(read);
+	parser.ClearObjects(objects);
+}
+
+void CSGTest::StatisticsTest() {
+	//the detailed statistics are filled in, the same in every run, and do not change the result of UnioinTest
+	typedef enterprise_manager::Context<Odouble>::Statistics Statistics;
+	enterprise_manager::Mesh<Odouble> plain, detailed;
+	enterprise_manager::Context<Odouble> plainContext;
+	_LoadObjects("input/cube_pyramid_1.txt", "", UNION, plainContext, Hook(), [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		objects[0]->GetMesh(plain);
+	});
+	const Statistics& plainStatistics = plainContext.statistics;
+	Obool zero = plainStatistics.extentTests == 0 && plainStatistics.overlappingPairs == 0 && plainStatistics.createdVertices == 0 && plainStatistics.existingVertices == 0;
+	for (Ouint phase = 0; phase < Statistics::PHASE_COUNT; ++phase)
+		zero = zero && plainStatistics.phaseNanoseconds[phase] == 0;
+	for (Ouint type = 0; type < Statistics::intersectionTypeCount; ++type)
+		zero = zero && plainStatistics.intersectionTypes[type] == 0;
+	_Check(zero, "StatisticsTest(): the detailed statistics stay zero without detailedStatistics");
+	_Check(plainStatistics.polygonPairs > 0 && plainStatistics.subdivisions > 0, "StatisticsTest(): the pairs and subdivisions are counted without detailedStatistics");
+
+	Statistics statistics[2];
+	for (Ouint i = 0; i < 2; ++i) {
+		enterprise_manager::Context<Odouble> context;
+		context.detailedStatistics = true;
+		_LoadObjects("input/cube_pyramid_1.txt", "", UNION, context, Hook(), [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+			objects[0]->GetMesh(detailed);
+		});
+		_Check(_SameMesh(plain, detailed), "StatisticsTest(): the result is the one of UnioinTest");
+		statistics[i] = context.statistics;
+	}
+	const Statistics& first = statistics[0];
+	const Statistics& second = statistics[1];
+	_Check(first.phaseNanoseconds[Statistics::SPLIT_FIRST] > 0 && first.phaseNanoseconds[Statistics::SPLIT_SECOND] > 0 && first.phaseNanoseconds[Statistics::DELETE_LISTS] > 0, "StatisticsTest(): the split and delete list phases are timed");
+	_Check(first.polygonPairs > 0 && first.subdivisions > 0 && first.createdVertices > 0, "StatisticsTest(): the pairs, subdivisions and created vertices are counted");
+	Obool stable = first.polygonPairs == second.polygonPairs && first.separatedPairs == second.separatedPairs && first.subdivisions == second.subdivisions &&
+		first.extentTests == second.extentTests && first.overlappingPairs == second.overlappingPairs && first.createdVertices == second.createdVertices && first.existingVertices == second.existingVertices;
+	for (Ouint type = 0; type < Statistics::intersectionTypeCount; ++type)
+		stable = stable && first.intersectionTypes[type] == second.intersectionTypes[type];
+	_Check(stable, "StatisticsTest(): the counters are the same in every run");
+	_Check(first.polygonPairs == plainStatistics.polygonPairs && first.subdivisions == plainStatistics.subdivisions, "StatisticsTest(): the pairs and subdivisions do not depend on detailedStatistics");
+}
+
+// The events passed to the trace callback of TraceTest.
+struct TraceEvents {
+	mutex lock;
+	vector<string> events;
+	Obool stopped;
+};
+
+void CSGTest::TraceTest() {
+	//the test project defines O_TRACE, the trace of a union is a JSON array of the events of its phases
+#ifndef O_TRACE
+	_Check(false, "TraceTest(): the tests are built with O_TRACE");
+#else
+	enterprise_manager::Mesh<Odouble> plain, traced;
+	enterprise_manager::Context<Odouble> plainContext;
+	_LoadObjects("input/cube_pyramid_1.txt", "", UNION, plainContext, Hook(), [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		objects[0]->GetMesh(plain);
+	});
+
+	_Check(enterprise_manager::Trace::Start("output/trace.json"), "TraceTest(): the trace file is opened");
+	enterprise_manager::Context<Odouble> context;
+	_LoadObjects("input/cube_pyramid_1.txt", "", UNION, context, Hook(), [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		objects[0]->GetMesh(traced);
+	});
+	enterprise_manager::Trace::Stop();
+	_Check(_SameMesh(plain, traced), "TraceTest(): the result is the one of UnioinTest");
+
+	ifstream file("output/trace.json");
+	stringstream trace;
+	trace << file.rdbuf();
+	_Check(_IsJsonArray(trace.str()), "TraceTest(): the trace is a JSON array");
+	_Check(trace.str().find("\"name\":\"SplitBy\"") != string::npos && trace.str().find("\"name\":\"MakeCcw\"") != string::npos, "TraceTest(): the trace holds the SplitBy and MakeCcw events");
+
+	//the callback gets the events on the threads of the operation and may stop the trace
+	TraceEvents events;
+	events.stopped = false;
+	enterprise_manager::Trace::Start([](const string& event, void* data) {
+		TraceEvents& events = *(TraceEvents*)data;
+		lock_guard<mutex> lock(events.lock);
+		events.events.push_back(event);
+		if (!events.stopped && event.find("\"name\":\"SplitBy\"") != string::npos) {
+			events.stopped = true;
+			enterprise_manager::Trace::Stop();
+		}
+	}, &events);
+	enterprise_manager::Context<Odouble> callbackContext;
+	callbackContext.threadCount = 4;
+	_LoadObjects("input/cube_pyramid_1.txt", "", UNION, callbackContext);
+	enterprise_manager::Trace::Stop();
+	Obool makeCcw = false;
+	for (Ouint i = 0; i < events.events.size(); ++i)
+		makeCcw = makeCcw || events.events[i].find("\"name\":\"MakeCcw\"") != string::npos;
+	_Check(makeCcw && events.stopped, "TraceTest(): the callback gets the SplitBy and MakeCcw events");
+	_Check(!enterprise_manager::Trace::enabled(), "TraceTest(): the callback stops the trace");
+#endif
+}
+
+// The reports passed to the progress callback of BudgetTest.
+struct BudgetProgress {
+	mutex lock;
+	vector<pair<enterprise_manager::Context<Odouble>::Statistics::Phase, Odouble>> reports;
+};
+
+void CSGTest::BudgetTest() {
+	//an operation over its budget or cancelled sets abortReason and leaves both objects as they were
+	typedef enterprise_manager::Context<Odouble> Context;
+	vector<enterprise_manager::Object<Odouble>*> input;
+	parser.ReadTestFile("input/cube_pyramid_1.txt", input);
+	auto aborted = [&](Context& context, Context::ABORT_REASON reason, const string& test) {
+		_LoadObjects("input/cube_pyramid_1.txt", "", UNION, context, Hook(), [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+			_Check(context.abortReason == reason, "BudgetTest(): " + test + " sets abortReason");
+			_Check(_SameObjects(objects, input) && !objects[0]->failed && !objects[1]->failed, "BudgetTest(): " + test + " leaves the objects as they were");
+		});
+	};
+
+	Context polygons;
+	polygons.budget.polygons = 1;
+	aborted(polygons, Context::POLYGON_LIMIT, "the polygon budget");
+
+	Context deadline;
+	deadline.budget.seconds = 1e-9;
+	aborted(deadline, Context::DEADLINE_PASSED, "the deadline");
+
+	Context bytes;
+	bytes.budget.bytes = 1;
+	aborted(bytes, Context::MEMORY_LIMIT, "the bytes budget");
+
+	//the token is cancelled by the progress callback once the first object is split
+	enterprise_manager::CancellationToken cancellation;
+	Context cancelled;
+	cancelled.cancellation = &cancellation;
+	cancelled.progress = [](Context::Statistics::Phase phase, Odouble fraction, void* data) {
+		if (phase == Context::Statistics::SPLIT_SECOND)
+			((enterprise_manager::CancellationToken*)data)->Cancel();
+	};
+	cancelled.progressData = &cancellation;
+	aborted(cancelled, Context::CANCELLED, "a token cancelled during the operation");
+	_Check(cancellation.cancelled(), "BudgetTest(): the token is cancelled during the operation");
+
+	//the result of UnioinTest as long as the token is not cancelled, with the progress of each phase reported
+	enterprise_manager::Mesh<Odouble> plain, result;
+	Context plainContext;
+	_LoadObjects("input/cube_pyramid_1.txt", "", UNION, plainContext, Hook(), [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		objects[0]->GetMesh(plain);
+	});
+	cancellation.Reset();
+	BudgetProgress progress;
+	Context context;
+	context.cancellation = &cancellation;
+	context.progress = [](Context::Statistics::Phase phase, Odouble fraction, void* data) {
+		BudgetProgress& progress = *(BudgetProgress*)data;
+		lock_guard<mutex> lock(progress.lock);
+		progress.reports.push_back(make_pair(phase, fraction));
+	};
+	context.progressData = &progress;
+	_LoadObjects("input/cube_pyramid_1.txt", "", UNION, context, Hook(), [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		objects[0]->GetMesh(result);
+	});
+	_Check(context.abortReason == Context::NOT_ABORTED && _SameMesh(plain, result), "BudgetTest(): the result is the one of UnioinTest unless the token is cancelled");
+	set<Context::Statistics::Phase> phases;
+	Obool fractions = true;
+	for (Ouint i = 0; i < progress.reports.size(); ++i) {
+		phases.insert(progress.reports[i].first);
+		fractions = fractions && progress.reports[i].second >= 0 && progress.reports[i].second <= 1;
+	}
+	_Check(phases.count(Context::Statistics::SPLIT_FIRST) && phases.count(Context::Statistics::SPLIT_SECOND) && phases.count(Context::Statistics::DELETE_LISTS), "BudgetTest(): the progress of the split and delete list phases is reported");
+	_Check(fractions, "BudgetTest(): the parts of the phases done are between 0 and 1");
+
+	//SUBDIVISION_LOOP is not tested: Subdivide replaces a polygon by more than one, so no input
+	//splits the last polygon of an object again and again
+	parser.ClearObjects(input);
+}
+
+void CSGTest::ExchangeTest() {
+	//OBJ and PLY files keep the points and polygons of the objects
+	vector<enterprise_manager::Object<Odouble>*> objects, exchanged;
+	parser.ReadTestFile("input/cube_pyramid_1.txt", objects);
+	_Exchange(objects, "output/cube_pyramid_1.obj", OBJ, exchanged);
+	_Check(objects.size() == 2 && _SameObjects(exchanged, objects), "ExchangeTest(): the objects read from OBJ files are those written");
+	parser.ClearObjects(exchanged);
+	_Exchange(objects, "output/cube_pyramid_1.ply", PLY, exchanged);
+	_Check(objects.size() == 2 && _SameObjects(exchanged, objects), "ExchangeTest(): the objects read from PLY files are those written");
+	parser.ClearObjects(exchanged);
+	parser.ClearObjects(objects);
+
+	//STL files hold triangles with float points, which are welded while they are read
+	enterprise_manager::Context<Odouble> context;
+	_LoadObjects("input/cube_pyramid_1.txt", "output/outputStlU.txt", UNION, context, [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		_Exchange(objects, "output/cube_pyramid_1.stl", STL, exchanged);
+		parser.ClearObjects(objects);
+		objects.swap(exchanged);
+	});
+	_LoadObjects("input/cube_pyramid_1.txt", "output/outputStlAsciiU.txt", UNION, context, [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+		_Exchange(objects, "output/cube_pyramid_1_ascii.stl", STL_ASCII, exchanged);
+		parser.ClearObjects(objects);
+		objects.swap(exchanged);
+	});
+}
+
+void CSGTest::ThreadTest() {
+	//the polygons of a generation are subdivided on several threads, the results must be those of one thread
+	const pair<string, Operation> tests[] = {
+		make_pair("input/cube_pyramid_1.txt", SPLIT_FIRST),
+		make_pair("input/cube_pyramid_1.txt", SUBDIVIDE_FIRST),
+		make_pair("input/cube_pyramid_1.txt", SUBDIVIDE_SECOND),
+		make_pair("input/beam_cone_vertex_touch.txt", SUBDIVIDE_FIRST),
+		make_pair("input/beam_cone_vertex_touch.txt", SUBDIVIDE_SECOND),
+		make_pair("input/wall_openings.txt", DIFFERENCE_ALL),
+		make_pair("input/union_cubes.txt", UNION_ALL),
+		//the polygons are also classified for the delete lists on several threads
+		make_pair("input/cube_pyramid_1.txt", UNION),
+		make_pair("input/cube_pyramid_1.txt", DIFFERENCE),
+		make_pair("input/cube_pyramid_1.txt", INTERSECTION),
+		make_pair("input/beam_cone_vertex_touch.txt", UNION),
+		make_pair("input/beam_cone_vertex_touch.txt", DIFFERENCE),
+		make_pair("input/beam_cone_vertex_touch.txt", INTERSECTION),
+		make_pair("input/u_prism_bar.txt", UNION),
+		make_pair("input/u_prism_bar.txt", DIFFERENCE)
+	};
+	for (const auto& test : tests) {
+		enterprise_manager::Mesh<Odouble> mesh[2];
+		const Ouint threadCount[] = { 1, 4 };
+		for (Ouint i = 0; i < 2; ++i) {
+			enterprise_manager::Context<Odouble> context;
+			context.threadCount = threadCount[i];
+			_LoadObjects(test.first, "", test.second, context, Hook(), [&](vector<enterprise_manager::Object<Odouble>*>& objects) {
+				objects[0]->GetMesh(mesh[i]);
+			});
+		}
+		_Check(mesh[0].offsets().size() > 1 && _SameMesh(mesh[0], mesh[1]), "ThreadTest(): " + test.first + " gives the same result on four threads");
+	}
+}
+
+Ouint CSGTest::failures() const {
+	return _failures;
+}
+
 void CSGTest() {
 
 }
@@ -57,20 +421,38 @@ void CSGTest::_LoadObject(const string & input, const string& output) {
 }
 
 void CSGTest::_LoadPairObjects(const string& input, const string& output, Operation operation) {
+	enterprise_manager::Context<Odouble> context;
+	_LoadObjects(input, output, operation, context);
+}
+
+void CSGTest::_LoadObjects(const string& input, const string& output, Operation operation, enterprise_manager::Context<Odouble>& context, const Hook& before, const Hook& after) {
 	vector<enterprise_manager::Object<Odouble>*> objects;
 	parser.ReadTestFile(input, objects);
 
-	if (objects.size() != 2) return;
+	Obool pair = (operation != UNION_ALL && operation != DIFFERENCE_ALL);
+	if (objects.size() < 2 || (pair && objects.size() != 2)) {
+		parser.ClearObjects(objects);
+		return;
+	}
+	if (before) {
+		before(objects);
+		if (objects.size() < 2 || (pair && objects.size() != 2)) {
+			parser.ClearObjects(objects);
+			return;
+		}
+	}
 
+	//SplitBy and SubdivideObjects run in the current context
+	enterprise_manager::ContextScope<Odouble> scope(context);
 	switch (operation) {
 	case UNION:
-		enterprise_manager::Object<Odouble>::CreateUnion(*objects[0], *objects[1]);
+		enterprise_manager::Object<Odouble>::CreateUnion(*objects[0], *objects[1], context);
 		break;
 	case DIFFERENCE:
-		enterprise_manager::Object<Odouble>::CreateDifference(*objects[0], *objects[1]);
+		enterprise_manager::Object<Odouble>::CreateDifference(*objects[0], *objects[1], context);
 		break;
 	case INTERSECTION:
-		enterprise_manager::Object<Odouble>::CreateIntersection(*objects[0], *objects[1]);
+		enterprise_manager::Object<Odouble>::CreateIntersection(*objects[0], *objects[1], context);
 		break;
 	case SPLIT_FIRST:
 		objects[0]->SplitBy(*objects[1]);
@@ -86,12 +468,216 @@ void CSGTest::_LoadPairObjects(const string& input, const string& output, Operat
 		enterprise_manager::Object<Odouble>::SubdivideObjects(*objects[0], *objects[1]);
 		std::swap(objects[0], objects[1]);
 		break;
+	case UNION_ALL: {
+		enterprise_manager::Object<Odouble>* result = enterprise_manager::Object<Odouble>::Union(objects, context);
+		parser.ClearObjects(objects);
+		objects.push_back(result);
+		break;
+	}
+	case DIFFERENCE_ALL: {
+		vector<enterprise_manager::Object<Odouble>*> openings(objects.begin() + 1, objects.end());
+		enterprise_manager::Object<Odouble>::CreateDifference(*objects[0], openings, context);
+		break;
+	}
+	default:
+		break;
 	}
+	if (after)
+		after(objects);
 
-	delete objects[1];
-	objects.erase(objects.begin() + 1);
+	while (objects.size() > 1) {
+		delete objects.back();
+		objects.pop_back();
+	}
 
-	parser.WriteTestFile(objects, output);
+	if (!output.empty())
+		parser.WriteTestFile(objects, output);
 	parser.ClearObjects(objects);
 }
 
+void CSGTest::_Exchange(const vector<enterprise_manager::Object<Odouble>*>& objects, const string& exchange, Format format, vector<enterprise_manager::Object<Odouble>*>& exchanged) {
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		vector<enterprise_manager::Object<Odouble>*> single(1, objects[i]);
+		string fileName = exchange;
+		fileName.insert(fileName.rfind('.'), "_" + to_string(i));
+		switch (format) {
+		case OBJ:
+			parser.WriteObjFile(single, fileName);
+			parser.ReadObjFile(fileName, exchanged);
+			break;
+		case STL:
+			parser.WriteStlFile(single, fileName);
+			parser.ReadStlFile(fileName, exchanged);
+			break;
+		case STL_ASCII:
+			parser.WriteStlFile(single, fileName, false);
+			parser.ReadStlFile(fileName, exchanged);
+			break;
+		case PLY:
+			parser.WritePlyFile(single, fileName);
+			parser.ReadPlyFile(fileName, exchanged);
+			break;
+		}
+	}
+}
+
+void CSGTest::_Check(Obool condition, const string& message) {
+	if (condition)
+		return;
+	++_failures;
+	cout << "\nCSGTest::" << message << " failed.";
+}
+
+Obool CSGTest::_SameObject(const enterprise_manager::Object<Odouble>& objectA, const enterprise_manager::Object<Odouble>& objectB, Odouble tolerance) {
+	enterprise_manager::Mesh<Odouble> meshA, meshB;
+	objectA.GetMesh(meshA);
+	objectB.GetMesh(meshB);
+	return _SameMesh(meshA, meshB, tolerance);
+}
+
+Obool CSGTest::_SameMesh(const enterprise_manager::Mesh<Odouble>& meshA, const enterprise_manager::Mesh<Odouble>& meshB, Odouble tolerance) {
+	if (meshA.coords().size() != meshB.coords().size() || meshA.offsets() != meshB.offsets() || meshA.indexes() != meshB.indexes())
+		return false;
+	for (Ouint i = 0; i < meshA.coords().size(); ++i) {
+		for (Ouint k = 0; k < 3; ++k) {
+			if (fabs(meshA.coords()[i][k] - meshB.coords()[i][k]) > tolerance)
+				return false;
+		}
+	}
+	return true;
+}
+
+Obool CSGTest::_IsClosed(const enterprise_manager::Object<Odouble>& object) {
+	enterprise_manager::Mesh<Odouble> mesh;
+	object.GetMesh(mesh);
+	//the vertices at the same point are the same vertex here, the operations do not merge all of them
+	map<tuple<Odouble, Odouble, Odouble>, Ouint> pointIndex;
+	vector<Ouint> index(mesh.coords().size());
+	for (Ouint i = 0; i < mesh.coords().size(); ++i)
+		index[i] = pointIndex.insert(make_pair(make_tuple(mesh.coords()[i][0], mesh.coords()[i][1], mesh.coords()[i][2]), i)).first->second;
+	map<pair<Ouint, Ouint>, Oint> edges;
+	for (Ouint i = 0; i + 1 < mesh.offsets().size(); ++i) {
+		Ouint first = mesh.offsets()[i];
+		Ouint count = mesh.offsets()[i + 1] - first;
+		for (Ouint j = 0; j < count; ++j) {
+			Ouint a = index[mesh.indexes()[first + j]];
+			Ouint b = index[mesh.indexes()[first + (j + 1) % count]];
+			++edges[make_pair(a, b)];
+			--edges[make_pair(b, a)];
+		}
+	}
+	for (auto it = edges.begin(); it != edges.end(); ++it) {
+		if (it->second != 0)
+			return false;
+	}
+	return true;
+}
+
+Obool CSGTest::_IsJsonArray(const string& text) {
+	Ouint i = 0;
+	_SkipJsonSpace(text, i);
+	if (i >= text.size() || text[i] != '[' || !_JsonValue(text, i))
+		return false;
+	_SkipJsonSpace(text, i);
+	return i == text.size();
+}
+
+void CSGTest::_SkipJsonSpace(const string& text, Ouint& i) {
+	while (i < text.size() && (text[i] == ' ' || text[i] == '\t' || text[i] == '\n' || text[i] == '\r'))
+		++i;
+}
+
+Obool CSGTest::_JsonValue(const string& text, Ouint& i) {
+	_SkipJsonSpace(text, i);
+	if (i >= text.size())
+		return false;
+	if (text[i] == '{' || text[i] == '[') {
+		Obool object = text[i] == '{';
+		Ochar close = object ? '}' : ']';
+		++i;
+		_SkipJsonSpace(text, i);
+		if (i < text.size() && text[i] == close) {
+			++i;
+			return true;
+		}
+		for (;;) {
+			if (object) {
+				_SkipJsonSpace(text, i);
+				if (i >= text.size() || text[i] != '"' || !_JsonValue(text, i))
+					return false;
+				_SkipJsonSpace(text, i);
+				if (i >= text.size() || text[i] != ':')
+					return false;
+				++i;
+			}
+			if (!_JsonValue(text, i))
+				return false;
+			_SkipJsonSpace(text, i);
+			if (i >= text.size())
+				return false;
+			if (text[i] == close) {
+				++i;
+				return true;
+			}
+			if (text[i] != ',')
+				return false;
+			++i;
+		}
+	}
+	if (text[i] == '"') {
+		for (++i; i < text.size() && text[i] != '"'; ++i) {
+			if ((unsigned char)text[i] < 0x20)
+				return false;
+			if (text[i] == '\\')
+				++i;
+		}
+		if (i >= text.size())
+			return false;
+		++i;
+		return true;
+	}
+	const char* literals[] = { "true", "false", "null" };
+	for (Ouint k = 0; k < 3; ++k) {
+		if (text.compare(i, strlen(literals[k]), literals[k]) == 0) {
+			i += (Ouint)strlen(literals[k]);
+			return true;
+		}
+	}
+	//a number, -?digits(.digits)?([eE][+-]?digits)?
+	Ouint start = i;
+	if (text[i] == '-')
+		++i;
+	Ouint digits = i;
+	while (i < text.size() && isdigit((unsigned char)text[i]))
+		++i;
+	if (i == digits)
+		return false;
+	if (i < text.size() && text[i] == '.') {
+		digits = ++i;
+		while (i < text.size() && isdigit((unsigned char)text[i]))
+			++i;
+		if (i == digits)
+			return false;
+	}
+	if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+		++i;
+		if (i < text.size() && (text[i] == '+' || text[i] == '-'))
+			++i;
+		digits = i;
+		while (i < text.size() && isdigit((unsigned char)text[i]))
+			++i;
+		if (i == digits)
+			return false;
+	}
+	return i > start;
+}
+
+Obool CSGTest::_SameObjects(const vector<enterprise_manager::Object<Odouble>*>& objectsA, const vector<enterprise_manager::Object<Odouble>*>& objectsB, Odouble tolerance) {
+	if (objectsA.size() != objectsB.size())
+		return false;
+	for (Ouint i = 0; i < objectsA.size(); ++i) {
+		if (!_SameObject(*objectsA[i], *objectsB[i], tolerance))
+			return false;
+	}
+	return true;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "FileManager.h"
+#include <functional>
 
 class CSGTest {
 public:
@@ -20,10 +21,62 @@ public:
 
 	void SubdivideTest();
 
+	void ConcurrencyTest();
+
+	void CloneTest();
+
+	void MultipleDifferenceTest();
+
+	void MultipleUnionTest();
+
+	void PlacementTest();
+
+	void ArrangementTest();
+
+	void TransformTest();
+
+	void BinaryFileTest();
+	void ExchangeTest();
+	void StatisticsTest();
+	void TraceTest();
+	void BudgetTest();
+	void ThreadTest();
+
+	// Number of checks failed by the tests run so far.
+	Ouint failures() const;
+
 private:
-	enum Operation { UNION, DIFFERENCE, INTERSECTION, SPLIT_FIRST, SPLIT_SECOND, SUBDIVIDE_FIRST, SUBDIVIDE_SECOND, NONE };
+	enum Operation { UNION, DIFFERENCE, INTERSECTION, SPLIT_FIRST, SPLIT_SECOND, SUBDIVIDE_FIRST, SUBDIVIDE_SECOND, UNION_ALL, DIFFERENCE_ALL, NONE };
+	// Run on the objects of a test before or after its operation.
+	typedef std::function<void(vector<enterprise_manager::Object<Odouble>*>& objects)> Hook;
+
 	FileManager parser;
+	Ouint _failures;
 	void _LoadObject(const string& input, const string& output);
 	void _LoadPairObjects(const string& input, const string& output, Operation operation);
+	// Read the objects of input, run before on them, the operation in the context
+	// and after on the objects again. The operation leaves its result in the first
+	// object, which is written to output unless output is empty. UNION_ALL unites
+	// all objects, DIFFERENCE_ALL subtracts the others from the first one.
+	void _LoadObjects(const string& input, const string& output, Operation operation, enterprise_manager::Context<Odouble>& context, const Hook& before = Hook(), const Hook& after = Hook());
+
+	enum Format { OBJ, STL, STL_ASCII, PLY };
+	// Write each object to its own file, as binary STL and PLY files hold a single
+	// mesh, and append the objects read back to exchanged.
+	void _Exchange(const vector<enterprise_manager::Object<Odouble>*>& objects, const string& exchange, Format format, vector<enterprise_manager::Object<Odouble>*>& exchanged);
+
+	// Count a failure and report it unless the condition holds.
+	void _Check(Obool condition, const string& message);
+	// Test if the objects have the same points, up to tolerance, and the same polygons.
+	static Obool _SameObject(const enterprise_manager::Object<Odouble>& objectA, const enterprise_manager::Object<Odouble>& objectB, Odouble tolerance = 0);
+	static Obool _SameMesh(const enterprise_manager::Mesh<Odouble>& meshA, const enterprise_manager::Mesh<Odouble>& meshB, Odouble tolerance = 0);
+	// Test if every edge of the polygons is the edge of another polygon in the opposite direction.
+	static Obool _IsClosed(const enterprise_manager::Object<Odouble>& object);
+	// Test if the text is a JSON array, as written by Trace.
+	static Obool _IsJsonArray(const string& text);
+	static void _SkipJsonSpace(const string& text, Ouint& i);
+	// Read a JSON value from i on and leave i after it.
+	static Obool _JsonValue(const string& text, Ouint& i);
+	static Obool _SameObjects(const vector<enterprise_manager::Object<Odouble>*>& objectsA, const vector<enterprise_manager::Object<Odouble>*>& objectsB, Odouble tolerance = 0);
 };
 
@@ -1,7 +1,24 @@
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "FileManager.h"
 #include "Object.h"
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <unordered_map>
 
 
 using namespace std;
@@ -16,161 +33,1206 @@ const string metaDelimeter = ", ";
 const string coordDelimeter = "; ";
 const string defaultColor = "0xD99308";
 
+// Layout of the binary mesh files. All numbers are little endian and every block
+// starts at a multiple of 8 bytes from the beginning of the file.
+const char binaryMagic[4] = { 'C', 'S', 'G', 'M' };
+const Ouint binaryVersion = 1;
+
+struct BinaryHeader {
+	char magic[4];
+	Ouint version;
+	Ouint objectCount;
+	Ouint reserved;
+	Ouint64 tableOffset;
+	Ouint64 fileSize;
+};
+
+// The coordinates are coordCount * 3 doubles, the offsets polygonCount + 1 Ouints
+// and the indexes indexCount Ouints. The metadata is metaSize bytes of text.
+struct BinaryObject {
+	Ouint64 coordOffset;
+	Ouint64 offsetOffset;
+	Ouint64 indexOffset;
+	Ouint64 metaOffset;
+	Ouint coordCount;
+	Ouint polygonCount;
+	Ouint indexCount;
+	Ouint metaSize;
+};
+
+// A file mapped read only into memory, unmapped on destruction.
+class MappedFile {
+public:
+	MappedFile(const string& path) : _data(NULL), _size(0) {
+#ifdef _WIN32
+		_mapping = NULL;
+		_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (_file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(_file, &size) || size.QuadPart == 0)
+			return;
+		_mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (!_mapping)
+			return;
+		_data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (_data)
+			_size = (size_t)size.QuadPart;
+#else
+		_file = open(path.c_str(), O_RDONLY);
+		if (_file < 0)
+			return;
+		struct stat status;
+		if (fstat(_file, &status) != 0 || status.st_size == 0)
+			return;
+		void* data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, _file, 0);
+		if (data == MAP_FAILED)
+			return;
+		madvise(data, (size_t)status.st_size, MADV_SEQUENTIAL);
+		_data = static_cast<const char*>(data);
+		_size = (size_t)status.st_size;
+#endif
+	}
+
+	~MappedFile() {
+#ifdef _WIN32
+		if (_data)
+			UnmapViewOfFile(_data);
+		if (_mapping)
+			CloseHandle(_mapping);
+		if (_file != INVALID_HANDLE_VALUE)
+			CloseHandle(_file);
+#else
+		if (_data)
+			munmap(const_cast<char*>(_data), _size);
+		if (_file >= 0)
+			close(_file);
+#endif
+	}
+
+	// Whether the file exists, an empty file is opened but has no data.
+	bool opened() const {
+#ifdef _WIN32
+		return _file != INVALID_HANDLE_VALUE;
+#else
+		return _file >= 0;
+#endif
+	}
+	const char* data() const { return _data; }
+	size_t size() const { return _size; }
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const char* _data;
+	size_t _size;
+#ifdef _WIN32
+	HANDLE _file;
+	HANDLE _mapping;
+#else
+	int _file;
+#endif
+};
+
+// Whether count items of itemSize bytes at offset lie within the file and are aligned for them.
+static bool _InFile(Ouint64 offset, Ouint64 count, Ouint64 itemSize, size_t fileSize) {
+	return offset % 8 == 0 && offset <= fileSize && count <= (fileSize - offset) / itemSize;
+}
+
+static Ouint64 _Align8(Ouint64 offset) {
+	return (offset + 7) & ~(Ouint64)7;
+}
+
+// Whether the line [line, end) has the header name, i.e. the text before its first ": ", or the whole line without one.
+static bool _IsHeader(const char* line, const char* end, const char* name) {
+	size_t length = strlen(name);
+	if ((size_t)(end - line) < length || memcmp(line, name, length) != 0)
+		return false;
+	return line + length == end || (end - line > (ptrdiff_t)length + 1 && line[length] == ':' && line[length + 1] == ' ');
+}
+
+// The powers of ten which are exact doubles.
+static const Odouble exactPowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// The arrays taken by Object::CreateFromIndexedPolygons, filled one polygon at a time.
+struct PolygonArrays {
+	vector<Odouble> coords;
+	vector<Ouint> offsets;
+	vector<Ouint> indexes;
+
+	PolygonArrays() : offsets(1, 0) {}
+
+	Ouint pointCount() const {
+		return (Ouint)(coords.size() / 3);
+	}
+
+	Ouint AddPoint(Odouble x, Odouble y, Odouble z) {
+		coords.push_back(x);
+		coords.push_back(y);
+		coords.push_back(z);
+		return pointCount() - 1;
+	}
+
+	// End the polygon of the indexes added since the last one, which is dropped with less than three of them.
+	void ClosePolygon() {
+		if (indexes.size() - offsets.back() < 3)
+			indexes.resize(offsets.back());
+		else
+			offsets.push_back((Ouint)indexes.size());
+	}
+
+	// Create an object of the polygons and start over. NULL without polygons.
+	enterprise_manager::Object<Odouble>* CreateObject() {
+		enterprise_manager::Object<Odouble>* object = NULL;
+		if (offsets.size() > 1)
+			object = enterprise_manager::Object<Odouble>::CreateFromIndexedPolygons(coords.data(), pointCount(), offsets.data(), indexes.data(), (Ouint)offsets.size() - 1);
+		coords.clear();
+		offsets.assign(1, 0);
+		indexes.clear();
+		return object;
+	}
+};
+
+// Gives equal points the same index in PolygonArrays, for the triangle soup of STL files.
+class PointWelder {
+public:
+	Ouint Index(PolygonArrays& arrays, Odouble x, Odouble y, Odouble z) {
+		//adding zero makes -0 equal to 0
+		Point point = { x + 0.0, y + 0.0, z + 0.0 };
+		std::pair<unordered_map<Point, Ouint, PointHash>::iterator, bool> inserted = _index.insert(make_pair(point, arrays.pointCount()));
+		if (inserted.second)
+			arrays.AddPoint(point.x, point.y, point.z);
+		return inserted.first->second;
+	}
+
+	// Add the polygon of count corners, which are x, y and z one after another. Corners welded
+	// to the previous one are left out.
+	void AddPolygon(PolygonArrays& arrays, const Odouble* corners, Ouint count) {
+		Ouint first = (Ouint)arrays.indexes.size();
+		for (Ouint i = 0; i < count; ++i, corners += 3) {
+			Ouint index = Index(arrays, corners[0], corners[1], corners[2]);
+			if (arrays.indexes.size() == first || arrays.indexes.back() != index)
+				arrays.indexes.push_back(index);
+		}
+		if (arrays.indexes.size() > first + 1 && arrays.indexes.back() == arrays.indexes[first])
+			arrays.indexes.pop_back();
+		arrays.ClosePolygon();
+	}
+
+	void Clear() {
+		_index.clear();
+	}
+
+private:
+	struct Point {
+		Odouble x, y, z;
+
+		bool operator==(const Point& other) const {
+			return x == other.x && y == other.y && z == other.z;
+		}
+	};
+
+	struct PointHash {
+		size_t operator()(const Point& point) const {
+			std::hash<Odouble> hash;
+			size_t seed = hash(point.x);
+			seed ^= hash(point.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= hash(point.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			return seed;
+		}
+	};
+
+	unordered_map<Point, Ouint, PointHash> _index;
+};
+
+// Collects the output and writes it to the file in large blocks.
+class BlockWriter {
+public:
+	BlockWriter(const string& fileName, bool binary)
+		: _file(fileName.c_str(), binary ? ios::out | ios::binary | ios::trunc : ios::out | ios::trunc) {
+		_buffer.reserve(blockSize + 4096);
+	}
+
+	~BlockWriter() {
+		Flush();
+	}
+
+	bool is_open() const {
+		return _file.is_open();
+	}
+
+	string& buffer() {
+		return _buffer;
+	}
+
+	void Append(const void* data, size_t size) {
+		_buffer.append(static_cast<const char*>(data), size);
+	}
+
+	// Write the buffer once a block is full.
+	void Check() {
+		if (_buffer.size() >= blockSize)
+			Flush();
+	}
+
+	void Flush() {
+		_file.write(_buffer.data(), _buffer.size());
+		_buffer.clear();
+	}
+
+private:
+	static const size_t blockSize = 1 << 20;
+
+	ofstream _file;
+	string _buffer;
+};
+
+static const char* _SkipBlanks(const char* c, const char* end) {
+	while (c < end && (*c == ' ' || *c == '\t'))
+		++c;
+	return c;
+}
+
+// Whether the word is at c, followed by a blank or the end of the line.
+static bool _IsKeyword(const char* c, const char* end, const char* word) {
+	size_t length = strlen(word);
+	if ((size_t)(end - c) < length || memcmp(c, word, length) != 0)
+		return false;
+	return c + length == end || c[length] == ' ' || c[length] == '\t' || c[length] == '\r' || c[length] == '\n';
+}
+
+// Parse an integer with an optional sign and return the position after it or NULL.
+static const char* _ParseInteger(const char* c, const char* end, Oint64& value) {
+	Obool negative = c < end && *c == '-';
+	if (c < end && (*c == '-' || *c == '+'))
+		++c;
+	if (c == end || *c < '0' || *c > '9')
+		return NULL;
+	value = 0;
+	for (; c < end && *c >= '0' && *c <= '9'; ++c) {
+		if (value < ((Oint64)1 << 40))
+			value = value * 10 + (*c - '0');
+	}
+	if (negative)
+		value = -value;
+	return c;
+}
+
+// Append the number with all the digits needed to read back the same double.
+static void _AppendExact(string& buffer, Odouble value) {
+	if (value == floor(value) && fabs(value) < 1e15 && !(value == 0 && signbit(value))) {
+		buffer += to_string((long long)value);
+		return;
+	}
+	char text[32];
+	Oint length = sprintf(text, "%.17g", value);
+	buffer.append(text, length);
+}
+
+// The scalar types of PLY properties.
+enum PlyType { PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64, PLY_TYPE_COUNT };
+
+static const char* plyTypeNames[][2] = {
+	{ "char", "int8" }, { "uchar", "uint8" }, { "short", "int16" }, { "ushort", "uint16" },
+	{ "int", "int32" }, { "uint", "uint32" }, { "float", "float32" }, { "double", "float64" }
+};
+static const Ouint plyTypeSizes[] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+// A property of an element of a PLY file, a scalar or a list whose count has countType.
+struct PlyProperty {
+	string name;
+	Obool list;
+	PlyType countType;
+	PlyType type;
+};
+
+struct PlyElement {
+	string name;
+	Ouint64 count;
+	vector<PlyProperty> properties;
+};
+
+static bool _PlyType(const string& name, PlyType& type) {
+	for (Ouint i = 0; i < PLY_TYPE_COUNT; ++i) {
+		if (name == plyTypeNames[i][0] || name == plyTypeNames[i][1]) {
+			type = (PlyType)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+// The value of the given type at data, whose bytes are reversed for big endian files.
+static Odouble _PlyValue(const char* data, PlyType type, bool swap) {
+	char bytes[8];
+	Ouint size = plyTypeSizes[type];
+	for (Ouint i = 0; i < size; ++i) {
+		bytes[i] = data[swap ? size - 1 - i : i];
+	}
+	switch (type) {
+	case PLY_INT8: { Oint8 value; memcpy(&value, bytes, 1); return value; }
+	case PLY_UINT8: { Ouint8 value; memcpy(&value, bytes, 1); return value; }
+	case PLY_INT16: { Oint16 value; memcpy(&value, bytes, 2); return value; }
+	case PLY_UINT16: { Ouint16 value; memcpy(&value, bytes, 2); return value; }
+	case PLY_INT32: { Oint32 value; memcpy(&value, bytes, 4); return value; }
+	case PLY_UINT32: { Ouint32 value; memcpy(&value, bytes, 4); return value; }
+	case PLY_FLOAT32: { Ofloat32 value; memcpy(&value, bytes, 4); return value; }
+	default: { Odouble value; memcpy(&value, bytes, 8); return value; }
+	}
+}
+
 void FileManager::ReadTestFile(const string& path, vector<enterprise_manager::Object<Odouble>*>& objects) {
-	ifstream file;
-	file.open(path.c_str(), std::ifstream::in);
+	MappedFile file(path);
+	if (!file.opened()) {
+		cout << " Failed to open" << endl;
+		return;
+	}
+	if (!file.data())
+		return;
 
-	if (!file.is_open()) {
+	//an object starts at each "Object" line, the lines before the first one belong to the first object
+	vector<TextObject> texts;
+	const char* data = file.data();
+	const char* end = data + file.size();
+	const char* begin = data;
+	for (const char* line = data; line < end;) {
+		const char* next = static_cast<const char*>(memchr(line, '\n', end - line));
+		next = next ? next + 1 : end;
+		if (line != begin && _IsHeader(line, next[-1] == '\n' ? next - 1 : next, "Object")) {
+			TextObject text = { begin, line, NULL, NULL };
+			texts.push_back(text);
+			begin = line;
+		}
+		line = next;
+	}
+	TextObject text = { begin, end, NULL, NULL };
+	texts.push_back(text);
+
+	enterprise_manager::ParallelFor<Odouble>((Ouint)texts.size(), 1, [&](Ouint first, Ouint last) {
+		for (Ouint i = first; i < last; ++i) {
+			_ParseObject(texts[i]);
+		}
+	});
+
+	for (Ouint i = 0; i < texts.size(); ++i) {
+		if (texts[i].error) {
+			const char* lineEnd = static_cast<const char*>(memchr(texts[i].error, '\n', end - texts[i].error));
+			cout << " Failed to parse: " << string(texts[i].error, lineEnd ? lineEnd : end) << endl;
+			for (Ouint k = 0; k < texts.size(); ++k) {
+				delete texts[k].object;
+			}
+			return;
+		}
+	}
+	for (Ouint i = 0; i < texts.size(); ++i) {
+		if (texts[i].object)
+			objects.push_back(texts[i].object);
+	}
+}
+
+void FileManager::WriteTestFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName) {
+	//the lines are collected and written in large blocks instead of being flushed one by one
+	BlockWriter writer(fileName, false);
+	string& buffer = writer.buffer();
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		buffer += "Object" + headerDelimeter + to_string(objects[i]->polygon().size()) + metaDelimeter + "Object" + to_string(i) + metaDelimeter + defaultColor + '\n';
+		for (Ouint j = 0; j < objects[i]->polygon().size(); ++j) {
+			const vector<enterprise_manager::Vertex<Odouble>*>& vertex = objects[i]->polygon()[j]->vertex();
+			buffer += "Facet" + headerDelimeter + to_string(vertex.size()) + metaDelimeter + "Facet" + to_string(j) + '\n';
+			for (Ouint k = 0; k < vertex.size(); ++k) {
+				_WriteNumber(buffer, vertex[k]->point()[0]);
+				buffer += coordDelimeter;
+				_WriteNumber(buffer, vertex[k]->point()[1]);
+				buffer += coordDelimeter;
+				_WriteNumber(buffer, vertex[k]->point()[2]);
+				buffer += '\n';
+			}
+			writer.Check();
+		}
+	}
+}
+
+void FileManager::ReadBinaryFile(const string& path, vector<enterprise_manager::Object<Odouble>*>& objects, vector<string>* metadata) {
+	MappedFile file(path);
+	if (!file.data()) {
 		cout << " Failed to open" << endl;
 		return;
 	}
 
-	string buffer;
+	const char* data = file.data();
+	const BinaryHeader* header = reinterpret_cast<const BinaryHeader*>(data);
+	if (file.size() < sizeof(BinaryHeader) || memcmp(header->magic, binaryMagic, sizeof(binaryMagic)) != 0 || header->version != binaryVersion ||
+		header->fileSize != file.size() || !_InFile(header->tableOffset, header->objectCount, sizeof(BinaryObject), file.size())) {
+		cout << " Not a binary mesh file" << endl;
+		return;
+	}
 
-	std::vector<enterprise_manager::Vec3<Odouble>> coord;
-	std::vector<Oint> coordIndex;
+	const BinaryObject* table = reinterpret_cast<const BinaryObject*>(data + header->tableOffset);
+	for (Ouint i = 0; i < header->objectCount; ++i) {
+		const BinaryObject& record = table[i];
+		if (!_InFile(record.coordOffset, (Ouint64)record.coordCount * 3, sizeof(Odouble), file.size()) ||
+			!_InFile(record.offsetOffset, (Ouint64)record.polygonCount + 1, sizeof(Ouint), file.size()) ||
+			!_InFile(record.indexOffset, record.indexCount, sizeof(Ouint), file.size()) ||
+			!_InFile(record.metaOffset, record.metaSize, 1, file.size())) {
+			cout << " Object " << i << " is out of the file" << endl;
+			return;
+		}
 
-	std::vector<std::pair<Transformation, enterprise_manager::Vec3d>> transformations;
+		//the offsets must be increasing and the indexes must name existing points, the object is built without further checks
+		const Odouble* coords = reinterpret_cast<const Odouble*>(data + record.coordOffset);
+		const Ouint* offsets = reinterpret_cast<const Ouint*>(data + record.offsetOffset);
+		const Ouint* indexes = reinterpret_cast<const Ouint*>(data + record.indexOffset);
+		bool valid = offsets[0] == 0 && offsets[record.polygonCount] == record.indexCount;
+		for (Ouint p = 0; valid && p < record.polygonCount; ++p)
+			valid = offsets[p] <= offsets[p + 1];
+		Ouint outside = 0;
+		for (Ouint k = 0; k < record.indexCount; ++k)
+			outside |= indexes[k] >= record.coordCount;
+		if (!valid || outside) {
+			cout << " Object " << i << " has invalid polygons" << endl;
+			return;
+		}
 
-	int index = -1;
-	while (getline(file, buffer)) {
-		if (buffer.empty())
-			continue;
+		objects.push_back(enterprise_manager::Object<Odouble>::CreateFromIndexedPolygons(coords, record.coordCount, offsets, indexes, record.polygonCount));
+		if (metadata)
+			metadata->push_back(string(data + record.metaOffset, record.metaSize));
+	}
+}
 
-		size_t headerPos = buffer.find(headerDelimeter);
-		string header = buffer.substr(0, headerPos);
+void FileManager::WriteBinaryFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName, const vector<string>* metadata) {
+	vector<enterprise_manager::Mesh<Odouble> > meshes(objects.size());
+	vector<string> meta(objects.size());
+	vector<BinaryObject> table(objects.size());
 
-		if (header == "Object") {
+	//lay the blocks out after the header and the table
+	BinaryHeader header;
+	memcpy(header.magic, binaryMagic, sizeof(binaryMagic));
+	header.version = binaryVersion;
+	header.objectCount = (Ouint)objects.size();
+	header.reserved = 0;
+	header.tableOffset = sizeof(BinaryHeader);
+	Ouint64 offset = _Align8(header.tableOffset + table.size() * sizeof(BinaryObject));
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		objects[i]->GetMesh(meshes[i]);
+		if (metadata && i < metadata->size())
+			meta[i] = (*metadata)[i];
+		else
+			meta[i] = "Object" + to_string(i) + metaDelimeter + defaultColor;
 
-			if (coord.size() > 0) {
-				coordIndex.push_back(-1);
-				//this mean we end parsing previous object data so we can push it inside our list of objects
-				objects.push_back(enterprise_manager::Object<Odouble>::CreateFromIndexedFaceSet(coord, coordIndex, false, false));
+		BinaryObject& record = table[i];
+		record.coordCount = (Ouint)meshes[i].coords().size();
+		record.polygonCount = meshes[i].polygonCount();
+		record.indexCount = (Ouint)meshes[i].indexes().size();
+		record.metaSize = (Ouint)meta[i].size();
+		record.coordOffset = offset;
+		offset = _Align8(offset + (Ouint64)record.coordCount * 3 * sizeof(Odouble));
+		record.offsetOffset = offset;
+		offset = _Align8(offset + ((Ouint64)record.polygonCount + 1) * sizeof(Ouint));
+		record.indexOffset = offset;
+		offset = _Align8(offset + (Ouint64)record.indexCount * sizeof(Ouint));
+		record.metaOffset = offset;
+		offset = _Align8(offset + record.metaSize);
+	}
+	header.fileSize = offset;
 
-				//time to start from the beginning for new object
-				index = -1;
-				transformations.clear();
-				coord.clear();
-				coordIndex.clear();
-			}
+	ofstream file(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!file.is_open()) {
+		cout << " Failed to open" << endl;
+		return;
+	}
 
-			string objectData = buffer.substr(headerPos + headerDelimeter.size());
-			_ParseObjectHeader(objectData);
+	const char padding[8] = {};
+	Ouint64 position = 0;
+	auto write = [&](const void* data, Ouint64 size, Ouint64 at) {
+		file.write(padding, at - position);
+		file.write(static_cast<const char*>(data), size);
+		position = at + size;
+	};
+	write(&header, sizeof(header), 0);
+	if (!table.empty())
+		write(table.data(), table.size() * sizeof(BinaryObject), header.tableOffset);
+	vector<Odouble> coords;
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		const BinaryObject& record = table[i];
+		const vector<enterprise_manager::Vec3d>& points = meshes[i].coords();
+		coords.resize(points.size() * 3);
+		for (Ouint k = 0; k < points.size(); ++k) {
+			coords[3 * k] = points[k][0];
+			coords[3 * k + 1] = points[k][1];
+			coords[3 * k + 2] = points[k][2];
 		}
+		write(coords.data(), coords.size() * sizeof(Odouble), record.coordOffset);
+		write(meshes[i].offsets().data(), meshes[i].offsets().size() * sizeof(Ouint), record.offsetOffset);
+		write(meshes[i].indexes().data(), meshes[i].indexes().size() * sizeof(Ouint), record.indexOffset);
+		write(meta[i].data(), meta[i].size(), record.metaOffset);
+	}
+	file.write(padding, header.fileSize - position);
+}
 
-		else if (header == "Facet") {
-			if (coord.size() > 0) { // we already parse few coordinates and this is not the first facet
-				coordIndex.push_back(-1);
+void FileManager::ReadObjFile(const string& path, vector<enterprise_manager::Object<Odouble>*>& objects) {
+	MappedFile file(path);
+	if (!file.opened()) {
+		cout << " Failed to open" << endl;
+		return;
+	}
+	if (!file.data())
+		return;
+
+	//the points are numbered through the whole file, each object gets its own copies of the points it uses
+	vector<Odouble> points;
+	vector<Oint> local;
+	vector<Ouint> used;
+	PolygonArrays arrays;
+	vector<enterprise_manager::Object<Odouble>*> read;
+	const char* end = file.data() + file.size();
+	const char* error = NULL;
+	for (const char* line = file.data(); line < end && !error;) {
+		const char* next = static_cast<const char*>(memchr(line, '\n', end - line));
+		const char* lineEnd = next ? next : end;
+		next = next ? next + 1 : end;
+
+		const char* c = _SkipBlanks(line, lineEnd);
+		if (_IsKeyword(c, lineEnd, "v")) {
+			++c;
+			for (Oint axis = 0; axis < 3 && c; ++axis) {
+				Odouble value;
+				c = _ParseNumber(c, lineEnd, value);
+				points.push_back(value);
+			}
+			if (!c)
+				error = line;
+			local.push_back(-1);
+		}
+		else if (_IsKeyword(c, lineEnd, "f")) {
+			//an index is 1 for the first point or -1 for the last one so far, followed by the ignored texture and normal indexes
+			for (++c;;) {
+				c = _SkipBlanks(c, lineEnd);
+				if (c == lineEnd || *c == '\r' || *c == '#')
+					break;
+				Oint64 index;
+				c = _ParseInteger(c, lineEnd, index);
+				index += index < 0 ? (Oint64)local.size() : -1;
+				if (!c || index < 0 || index >= (Oint64)local.size()) {
+					error = line;
+					break;
+				}
+				while (c < lineEnd && *c != ' ' && *c != '\t' && *c != '\r')
+					++c;
+				if (local[index] < 0) {
+					local[index] = arrays.AddPoint(points[3 * index], points[3 * index + 1], points[3 * index + 2]);
+					used.push_back((Ouint)index);
+				}
+				arrays.indexes.push_back(local[index]);
+			}
+			arrays.ClosePolygon();
+		}
+		else if (_IsKeyword(c, lineEnd, "o")) {
+			enterprise_manager::Object<Odouble>* object = arrays.CreateObject();
+			if (object)
+				read.push_back(object);
+			for (Ouint i = 0; i < used.size(); ++i) {
+				local[used[i]] = -1;
 			}
+			used.clear();
+		}
+		//normals, texture coordinates, groups, materials and comments are skipped
+		line = next;
+	}
+	enterprise_manager::Object<Odouble>* object = arrays.CreateObject();
+	if (object)
+		read.push_back(object);
 
-			string facetData = buffer.substr(headerPos + headerDelimeter.size());
-			_ParseFacetHeader(facetData);
+	if (error) {
+		const char* lineEnd = static_cast<const char*>(memchr(error, '\n', end - error));
+		cout << " Failed to parse: " << string(error, lineEnd ? lineEnd : end) << endl;
+		ClearObjects(read);
+		return;
+	}
+	objects.insert(objects.end(), read.begin(), read.end());
+}
+
+void FileManager::ReadStlFile(const string& path, vector<enterprise_manager::Object<Odouble>*>& objects) {
+	MappedFile file(path);
+	if (!file.opened()) {
+		cout << " Failed to open" << endl;
+		return;
+	}
+	if (!file.data())
+		return;
+
+	PolygonArrays arrays;
+	PointWelder welder;
+	const char* data = file.data();
+	const char* end = data + file.size();
+
+	//a binary file has a header of 80 bytes, the triangle count and 50 bytes per triangle, its header may start with "solid" as well
+	Ouint32 count = 0;
+	if (file.size() >= 84)
+		memcpy(&count, data + 80, sizeof(count));
+	if (file.size() >= 84 && 84 + 50 * (Ouint64)count == file.size()) {
+		arrays.coords.reserve(3 * (count / 2 + 2));
+		arrays.offsets.reserve(count + 1);
+		arrays.indexes.reserve(3 * (Osize)count);
+		for (Ouint t = 0; t < count; ++t) {
+			//the normal is followed by the corners
+			Ofloat32 values[12];
+			memcpy(values, data + 84 + 50 * (Osize)t, sizeof(values));
+			Odouble corners[9];
+			for (Ouint i = 0; i < 9; ++i) {
+				corners[i] = values[3 + i];
+			}
+			welder.AddPolygon(arrays, corners, 3);
 		}
-		else if (header == "Translation") {
-			enterprise_manager::Vec3d vector;
-			string vectorData = buffer.substr(headerPos + headerDelimeter.size());
-			_ParsePoint(vectorData, vector);
-			cout << "Translation will be made along vector: (" << vector[0] << "; " << vector[1] << "; " << vector[2] << ")" << endl;
-			transformations.push_back(std::make_pair(Translation, vector));
+		enterprise_manager::Object<Odouble>* object = arrays.CreateObject();
+		if (object)
+			objects.push_back(object);
+		return;
+	}
+
+	const char* c = _SkipBlanks(data, end);
+	if (!_IsKeyword(c, end, "solid")) {
+		cout << " Not an STL file" << endl;
+		return;
+	}
+	vector<enterprise_manager::Object<Odouble>*> read;
+	vector<Odouble> loop;
+	const char* error = NULL;
+	for (const char* line = data; line < end && !error;) {
+		const char* next = static_cast<const char*>(memchr(line, '\n', end - line));
+		const char* lineEnd = next ? next : end;
+		next = next ? next + 1 : end;
+
+		c = _SkipBlanks(line, lineEnd);
+		if (_IsKeyword(c, lineEnd, "vertex")) {
+			c += 6;
+			for (Oint axis = 0; axis < 3 && c; ++axis) {
+				Odouble value;
+				c = _ParseNumber(c, lineEnd, value);
+				loop.push_back(value);
+			}
+			if (!c)
+				error = line;
 		}
-		else if (header == "Scale") {
-			enterprise_manager::Vec3d vector;
-			string vectorData = buffer.substr(headerPos + headerDelimeter.size());
-			enterprise_manager::Vec3d scale(stod(vectorData), 0, 0);
-			cout << "Scale will be made in: (" << scale[0] << " units." << endl;
-			transformations.push_back(std::make_pair(Scale, scale));
+		else if (_IsKeyword(c, lineEnd, "endloop")) {
+			welder.AddPolygon(arrays, loop.data(), (Ouint)loop.size() / 3);
+			loop.clear();
 		}
-		else {
-			++index;
-			enterprise_manager::Vec3d vertex;
-			_ParsePoint(buffer, vertex);
-			_Transform(vertex, transformations);
-			coord.push_back(vertex);
-			coordIndex.push_back(index);
+		else if (_IsKeyword(c, lineEnd, "endsolid")) {
+			enterprise_manager::Object<Odouble>* object = arrays.CreateObject();
+			if (object)
+				read.push_back(object);
+			welder.Clear();
 		}
+		line = next;
 	}
+	enterprise_manager::Object<Odouble>* object = arrays.CreateObject();
+	if (object)
+		read.push_back(object);
 
-	//init last object
-	if (coord.size() > 0) {
-		coordIndex.push_back(-1);//close last polygon
-		objects.push_back(enterprise_manager::Object<Odouble>::CreateFromIndexedFaceSet(coord, coordIndex, false, false));
+	if (error) {
+		const char* lineEnd = static_cast<const char*>(memchr(error, '\n', end - error));
+		cout << " Failed to parse: " << string(error, lineEnd ? lineEnd : end) << endl;
+		ClearObjects(read);
+		return;
 	}
+	objects.insert(objects.end(), read.begin(), read.end());
 }
 
-void FileManager::WriteTestFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName) {
-	ofstream file;
-	file.open(fileName.c_str());
+void FileManager::ReadPlyFile(const string& path, vector<enterprise_manager::Object<Odouble>*>& objects) {
+	MappedFile file(path);
+	if (!file.opened()) {
+		cout << " Failed to open" << endl;
+		return;
+	}
 
-	for (Oint i = 0; i < objects.size(); ++i) {
-		file << "Object" << headerDelimeter << objects[i]->polygon().size() << metaDelimeter << "Object" << i << metaDelimeter << defaultColor << endl;
-		for (Oint j = 0; j < objects[i]->polygon().size(); ++j) {
-			file << "Facet" << headerDelimeter << objects[i]->polygon()[j]->vertex().size() << metaDelimeter << "Facet" << j << endl;
-			for (Oint k = 0; k < objects[i]->polygon()[j]->vertex().size(); ++k) {
-				file << objects[i]->polygon()[j]->vertex()[k]->point()[0] << coordDelimeter
-					<< objects[i]->polygon()[j]->vertex()[k]->point()[1]
-					<< coordDelimeter << objects[i]->polygon()[j]->vertex()[k]->point()[2] << endl;
+	//the header is text up to the line "end_header"
+	const char* data = file.data();
+	const char* end = data + file.size();
+	const char* body = NULL;
+	for (const char* line = data; line < end;) {
+		const char* next = static_cast<const char*>(memchr(line, '\n', end - line));
+		if (!next)
+			break;
+		if (_IsKeyword(line, next, "end_header")) {
+			body = next + 1;
+			break;
+		}
+		line = next + 1;
+	}
+	if (!data || !body || !_IsKeyword(data, end, "ply")) {
+		cout << " Not a PLY file" << endl;
+		return;
+	}
+
+	istringstream header(string(data, body));
+	string line;
+	bool binary = false;
+	bool swap = false;
+	vector<PlyElement> elements;
+	while (getline(header, line)) {
+		istringstream words(line);
+		string keyword;
+		words >> keyword;
+		if (keyword == "format") {
+			string format;
+			words >> format;
+			binary = format == "binary_little_endian" || format == "binary_big_endian";
+			swap = format == "binary_big_endian";
+		}
+		else if (keyword == "element") {
+			PlyElement element;
+			words >> element.name >> element.count;
+			elements.push_back(element);
+		}
+		else if (keyword == "property" && !elements.empty()) {
+			PlyProperty property;
+			string type;
+			words >> type;
+			property.list = type == "list";
+			property.countType = PLY_UINT8;
+			if (property.list) {
+				string countType;
+				words >> countType >> type;
+				if (!_PlyType(countType, property.countType)) {
+					cout << " Unknown PLY type " << countType << endl;
+					return;
+				}
 			}
+			if (!_PlyType(type, property.type)) {
+				cout << " Unknown PLY type " << type << endl;
+				return;
+			}
+			words >> property.name;
+			elements.back().properties.push_back(property);
 		}
 	}
-}
+	if (!binary) {
+		cout << " Only binary PLY files are read" << endl;
+		return;
+	}
 
-void FileManager::_ParseObjectHeader(string& headerString) {
-	size_t amountPos = headerString.find_first_of(metaDelimeter);
+	//the points are the x, y and z of the element "vertex", the polygons the index lists of the element "face"
+	PolygonArrays arrays;
+	const char* c = body;
+	for (Ouint e = 0; e < elements.size(); ++e) {
+		const PlyElement& element = elements[e];
+		bool vertex = element.name == "vertex";
+		bool face = element.name == "face";
+		for (Ouint64 r = 0; r < element.count; ++r) {
+			Odouble point[3] = { 0, 0, 0 };
+			for (Ouint p = 0; p < element.properties.size(); ++p) {
+				const PlyProperty& property = element.properties[p];
+				Ouint64 items = 1;
+				if (property.list) {
+					if (end - c < plyTypeSizes[property.countType]) {
+						cout << " The PLY file is cut short" << endl;
+						return;
+					}
+					Odouble value = _PlyValue(c, property.countType, swap);
+					items = value > 0 ? (Ouint64)value : 0;
+					c += plyTypeSizes[property.countType];
+				}
+				if ((Ouint64)(end - c) / plyTypeSizes[property.type] < items) {
+					cout << " The PLY file is cut short" << endl;
+					return;
+				}
+				if (vertex && !property.list && (property.name == "x" || property.name == "y" || property.name == "z")) {
+					point[property.name[0] - 'x'] = _PlyValue(c, property.type, swap);
+				}
+				else if (face && property.list && (property.name == "vertex_indices" || property.name == "vertex_index")) {
+					for (Ouint64 i = 0; i < items; ++i) {
+						Odouble index = _PlyValue(c + i * plyTypeSizes[property.type], property.type, swap);
+						arrays.indexes.push_back(index >= 0 && index < 4294967295.0 ? (Ouint)index : (Ouint)-1);
+					}
+					arrays.ClosePolygon();
+				}
+				c += items * plyTypeSizes[property.type];
+			}
+			if (vertex)
+				arrays.AddPoint(point[0], point[1], point[2]);
+		}
+	}
 
-	int amounOfFacets;
-	string id, color;
+	for (Ouint i = 0; i < arrays.indexes.size(); ++i) {
+		if (arrays.indexes[i] >= arrays.pointCount()) {
+			cout << " The PLY file has an invalid vertex index" << endl;
+			return;
+		}
+	}
+	enterprise_manager::Object<Odouble>* object = arrays.CreateObject();
+	if (object)
+		objects.push_back(object);
+}
 
-	if (amountPos != string::npos) {
-		string test = headerString.substr(0, amountPos);
-		amounOfFacets = stoi(headerString.substr(0, amountPos));
+void FileManager::WriteObjFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName) {
+	BlockWriter writer(fileName, false);
+	if (!writer.is_open()) {
+		cout << " Failed to open" << endl;
+		return;
+	}
 
-		headerString = headerString.substr(amountPos + metaDelimeter.size());
+	string& buffer = writer.buffer();
+	vector<enterprise_manager::Vec3<CSGReal> > coord;
+	vector<Oint> coordIndex;
+	Ouint base = 1;
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		objects[i]->GetCoords(coord);
+		objects[i]->GetFaceSetIndexes(coordIndex);
+		buffer += "o Object" + to_string(i) + '\n';
+		for (Ouint k = 0; k < coord.size(); ++k) {
+			buffer += "v ";
+			_AppendExact(buffer, coord[k][0]);
+			buffer += ' ';
+			_AppendExact(buffer, coord[k][1]);
+			buffer += ' ';
+			_AppendExact(buffer, coord[k][2]);
+			buffer += '\n';
+			writer.Check();
+		}
+		//a polygon without indexes is not written
+		Obool open = false;
+		for (Ouint k = 0; k < coordIndex.size(); ++k) {
+			if (coordIndex[k] == -1) {
+				if (open)
+					buffer += '\n';
+				open = false;
+				writer.Check();
+			}
+			else {
+				buffer += open ? " " : "f ";
+				buffer += to_string(base + coordIndex[k]);
+				open = true;
+			}
+		}
+		base += (Ouint)coord.size();
+	}
+}
 
-		size_t colorPos = headerString.find(metaDelimeter);
+void FileManager::WriteStlFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName, Obool binary) {
+	BlockWriter writer(fileName, binary);
+	if (!writer.is_open()) {
+		cout << " Failed to open" << endl;
+		return;
+	}
 
-		if (colorPos != string::npos) {
-			id = headerString.substr(0, colorPos);
-			color = headerString.substr(colorPos + metaDelimeter.size());
+	string& buffer = writer.buffer();
+	if (binary) {
+		//the header must not start with "solid", which marks ASCII files
+		char header[80] = "binary STL";
+		writer.Append(header, sizeof(header));
+		Ouint32 count = 0;
+		for (Ouint i = 0; i < objects.size(); ++i) {
+			const vector<enterprise_manager::Polygon<Odouble>*>& polygons = objects[i]->polygon();
+			for (Ouint j = 0; j < polygons.size(); ++j) {
+				if (polygons[j] && polygons[j]->vertex().size() > 2)
+					count += (Ouint32)polygons[j]->vertex().size() - 2;
+			}
 		}
-		else
-			id = headerString; //no color data
+		writer.Append(&count, sizeof(count));
 	}
-	else
-		amounOfFacets = stoi(headerString); //only amount of facets specified
 
-	cout << "Object " << id << " was created with " << amounOfFacets << " facets of color " << color << endl;
+	vector<enterprise_manager::Vec3<CSGReal> > coord;
+	vector<Oint> coordIndex;
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		objects[i]->GetCoords(coord);
+		objects[i]->GetFaceSetIndexes(coordIndex);
+		if (!binary)
+			buffer += "solid Object" + to_string(i) + '\n';
+		//each polygon is a fan of triangles around its first vertex
+		for (Ouint first = 0, k = 0; k < coordIndex.size(); ++k) {
+			if (coordIndex[k] != -1)
+				continue;
+			for (Ouint t = first + 1; t + 1 < k; ++t) {
+				const enterprise_manager::Vec3d* corners[3] = { &coord[coordIndex[first]], &coord[coordIndex[t]], &coord[coordIndex[t + 1]] };
+				enterprise_manager::Vec3d normal = (*corners[1] - *corners[0]).Cross(*corners[2] - *corners[0]);
+				if (normal.Length() > 0)
+					normal.Normalize();
+				if (binary) {
+					Ofloat32 values[12];
+					for (Ouint axis = 0; axis < 3; ++axis) {
+						values[axis] = (Ofloat32)normal[axis];
+						values[3 + axis] = (Ofloat32)(*corners[0])[axis];
+						values[6 + axis] = (Ofloat32)(*corners[1])[axis];
+						values[9 + axis] = (Ofloat32)(*corners[2])[axis];
+					}
+					Ouint16 attributes = 0;
+					writer.Append(values, sizeof(values));
+					writer.Append(&attributes, sizeof(attributes));
+				}
+				else {
+					buffer += "facet normal ";
+					_WriteNumber(buffer, normal[0] + 0.0);
+					buffer += ' ';
+					_WriteNumber(buffer, normal[1] + 0.0);
+					buffer += ' ';
+					_WriteNumber(buffer, normal[2] + 0.0);
+					buffer += "\n outer loop\n";
+					for (Ouint v = 0; v < 3; ++v) {
+						buffer += "  vertex ";
+						_AppendExact(buffer, (*corners[v])[0]);
+						buffer += ' ';
+						_AppendExact(buffer, (*corners[v])[1]);
+						buffer += ' ';
+						_AppendExact(buffer, (*corners[v])[2]);
+						buffer += '\n';
+					}
+					buffer += " endloop\nendfacet\n";
+				}
+				writer.Check();
+			}
+			first = k + 1;
+		}
+		if (!binary)
+			buffer += "endsolid Object" + to_string(i) + '\n';
+	}
 }
 
-void FileManager::_ParseFacetHeader(string& facetString) {
-	size_t amountPos = facetString.find_first_of(metaDelimeter);
+void FileManager::WritePlyFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName) {
+	BlockWriter writer(fileName, true);
+	if (!writer.is_open()) {
+		cout << " Failed to open" << endl;
+		return;
+	}
 
-	int amounOfPoints;
-	string id;
+	//the header needs the counts, the polygons are written with a byte for their size unless one has more vertices
+	vector<enterprise_manager::Vec3<CSGReal> > coord;
+	vector<Oint> coordIndex;
+	Ouint64 vertexCount = 0;
+	Ouint64 faceCount = 0;
+	Osize maxSize = 0;
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		objects[i]->GetCoords(coord);
+		vertexCount += coord.size();
+		const vector<enterprise_manager::Polygon<Odouble>*>& polygons = objects[i]->polygon();
+		faceCount += polygons.size();
+		for (Ouint j = 0; j < polygons.size(); ++j) {
+			if (polygons[j])
+				maxSize = O_MAX(maxSize, polygons[j]->vertex().size());
+		}
+	}
+	Obool smallFaces = maxSize <= 255;
 
-	if (amountPos != string::npos) {
-		string test = facetString.substr(0, amountPos);
-		amounOfPoints = stoi(facetString.substr(0, amountPos));
-		id = facetString.substr(amountPos + metaDelimeter.size());
+	string& buffer = writer.buffer();
+	buffer += "ply\nformat binary_little_endian 1.0\n";
+	buffer += "element vertex " + to_string(vertexCount) + "\n";
+	buffer += "property double x\nproperty double y\nproperty double z\n";
+	buffer += "element face " + to_string(faceCount) + "\n";
+	buffer += smallFaces ? "property list uchar uint vertex_indices\n" : "property list uint uint vertex_indices\n";
+	buffer += "end_header\n";
+
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		objects[i]->GetCoords(coord);
+		for (Ouint k = 0; k < coord.size(); ++k) {
+			Odouble point[3] = { coord[k][0], coord[k][1], coord[k][2] };
+			writer.Append(point, sizeof(point));
+			writer.Check();
+		}
 	}
-	else
-		amounOfPoints = stoi(facetString); //only amount of points specified
+	Ouint32 base = 0;
+	for (Ouint i = 0; i < objects.size(); ++i) {
+		objects[i]->GetCoords(coord);
+		objects[i]->GetFaceSetIndexes(coordIndex);
+		for (Ouint first = 0, k = 0; k < coordIndex.size(); ++k) {
+			if (coordIndex[k] != -1)
+				continue;
+			Ouint32 size = k - first;
+			if (smallFaces) {
+				Ouint8 smallSize = (Ouint8)size;
+				writer.Append(&smallSize, sizeof(smallSize));
+			}
+			else {
+				writer.Append(&size, sizeof(size));
+			}
+			for (; first < k; ++first) {
+				Ouint32 index = base + coordIndex[first];
+				writer.Append(&index, sizeof(index));
+			}
+			first = k + 1;
+			writer.Check();
+		}
+		base += (Ouint32)coord.size();
+	}
+}
+
+/* static */ void FileManager::_ParseObject(TextObject& text) {
+	//each line is a point or adds an index, so the line count bounds the arrays
+	Osize lines = 1;
+	for (const char* c = text.begin; (c = static_cast<const char*>(memchr(c, '\n', text.end - c))) != NULL; ++c) {
+		++lines;
+	}
+	std::vector<enterprise_manager::Vec3<Odouble>> coord;
+	std::vector<Oint> coordIndex;
+	coord.reserve(lines);
+	coordIndex.reserve(lines + 1);
 
-	cout << "\tFacet " << id << " is existing with " << amounOfPoints << " points" << endl;
+	std::vector<std::pair<Transformation, enterprise_manager::Vec3d>> transformations;
 
+	for (const char* line = text.begin; line < text.end;) {
+		const char* next = static_cast<const char*>(memchr(line, '\n', text.end - line));
+		const char* lineEnd = next ? next : text.end;
+		next = next ? next + 1 : text.end;
+		if (line == lineEnd) {
+			line = next;
+			continue;
+		}
+
+		//the value follows the header and ": "
+		const char* value = lineEnd;
+		for (const char* c = line; c + 1 < lineEnd; ++c) {
+			if (c[0] == ':' && c[1] == ' ') {
+				value = c + 2;
+				break;
+			}
+		}
+
+		if (_IsHeader(line, lineEnd, "Object")) {
+			//the counts of facets and points are not needed, the arrays grow as the lines come
+		}
+		else if (_IsHeader(line, lineEnd, "Facet")) {
+			if (coord.size() > 0) { // we already parse few coordinates and this is not the first facet
+				coordIndex.push_back(-1);
+			}
+		}
+		else if (_IsHeader(line, lineEnd, "Translation")) {
+			enterprise_manager::Vec3d vector;
+			if (!_ParsePoint(value, lineEnd, vector)) {
+				text.error = line;
+				return;
+			}
+			transformations.push_back(std::make_pair(Translation, vector));
+		}
+		else if (_IsHeader(line, lineEnd, "Scale")) {
+			Odouble scale;
+			if (!_ParseNumber(value, lineEnd, scale)) {
+				text.error = line;
+				return;
+			}
+			transformations.push_back(std::make_pair(Scale, enterprise_manager::Vec3d(scale, 0, 0)));
+		}
+		else {
+			enterprise_manager::Vec3d vertex;
+			if (!_ParsePoint(line, lineEnd, vertex)) {
+				text.error = line;
+				return;
+			}
+			_Transform(vertex, transformations);
+			coord.push_back(vertex);
+			coordIndex.push_back((Oint)coord.size() - 1);
+		}
+		line = next;
+	}
+
+	if (coord.size() > 0) {
+		coordIndex.push_back(-1);//close last polygon
+		text.object = enterprise_manager::Object<Odouble>::CreateFromIndexedFaceSet(coord, coordIndex, false, false);
+	}
 }
 
-void FileManager::_ParsePoint(std::string& point, enterprise_manager::Vec3d& vertex) {
-	if (point[point.length() - 1] == ';')
-		point.erase(point.length() - 1);
+/* static */ const char* FileManager::_ParseNumber(const char* begin, const char* end, Odouble& value) {
+	while (begin < end && (*begin == ' ' || *begin == '\t'))
+		++begin;
+	const char* token = begin;
+	while (token < end && *token != ';' && *token != ' ' && *token != '\t' && *token != '\r')
+		++token;
 
-	size_t xPos = point.find(coordDelimeter);
-	size_t yPos = point.find_last_of(coordDelimeter);
+	//decimal numbers of up to 15 digits scaled by an exact power of ten are converted with a
+	//single rounding, which gives the same double as strtod
+	const char* c = begin;
+	Obool negative = c < token && *c == '-';
+	if (c < token && (*c == '-' || *c == '+'))
+		++c;
+	Ouint64 mantissa = 0;
+	Oint digits = 0;
+	Oint exponent = 0;
+	Obool any = false;
+	Obool exact = true;
+	for (; c < token && *c >= '0' && *c <= '9'; ++c) {
+		any = true;
+		if (mantissa == 0 && *c == '0')
+			continue;
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (*c - '0');
+			++digits;
+		}
+		else {
+			exact = false;
+		}
+	}
+	if (c < token && *c == '.') {
+		for (++c; c < token && *c >= '0' && *c <= '9'; ++c) {
+			any = true;
+			if (mantissa == 0 && *c == '0') {
+				--exponent;
+				continue;
+			}
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*c - '0');
+				++digits;
+				--exponent;
+			}
+			else {
+				exact = false;
+			}
+		}
+	}
+	if (any && c < token && (*c == 'e' || *c == 'E')) {
+		const char* e = c + 1;
+		Obool negativeExponent = e < token && *e == '-';
+		if (e < token && (*e == '-' || *e == '+'))
+			++e;
+		if (e < token && *e >= '0' && *e <= '9') {
+			Oint power = 0;
+			for (; e < token && *e >= '0' && *e <= '9'; ++e) {
+				if (power < 10000)
+					power = power * 10 + (*e - '0');
+			}
+			exponent += negativeExponent ? -power : power;
+			c = e;
+		}
+	}
+	if (any && c == token && exact && digits <= 15 && (mantissa == 0 || (exponent >= -22 && exponent <= 22))) {
+		value = (Odouble)mantissa;
+		if (mantissa != 0 && exponent > 0)
+			value *= exactPowersOfTen[exponent];
+		else if (mantissa != 0 && exponent < 0)
+			value /= exactPowersOfTen[-exponent];
+		if (negative)
+			value = -value;
+		return c;
+	}
 
-	vertex[0] = stod(point.substr(0, xPos));
-	vertex[1] = stod(point.substr(xPos + 1, yPos));
-	vertex[2] = stod(point.substr(yPos + 1));
+	//anything else, long mantissas, large exponents, hexadecimal or infinity, goes through strtod
+	char buffer[128];
+	size_t length = O_MIN((size_t)(token - begin), sizeof(buffer) - 1);
+	memcpy(buffer, begin, length);
+	buffer[length] = 0;
+	char* parsed;
+	value = strtod(buffer, &parsed);
+	if (parsed == buffer)
+		return NULL;
+	return begin + (parsed - buffer);
+}
 
-	cout << "\t\tX:" << vertex[0] << " Y:" << vertex[1] << " Z:" << vertex[2] << endl;
+/* static */ const char* FileManager::_ParsePoint(const char* begin, const char* end, enterprise_manager::Vec3d& vertex) {
+	//as with stod, anything after a number up to the next delimiter is ignored
+	for (Oint axis = 0; axis < 3; ++axis) {
+		if (axis > 0) {
+			begin = static_cast<const char*>(memchr(begin, ';', end - begin));
+			if (!begin)
+				return NULL;
+			++begin;
+		}
+		Odouble coordinate;
+		begin = _ParseNumber(begin, end, coordinate);
+		if (!begin)
+			return NULL;
+		vertex[axis] = coordinate;
+	}
+	return begin;
 }
 
 void FileManager::ClearObjects(vector<enterprise_manager::Object<Odouble>*>& objects) {
@@ -183,7 +1245,7 @@ void FileManager::ClearObjects(vector<enterprise_manager::Object<Odouble>*>& obj
 }
 
 void FileManager::_Transform(enterprise_manager::Vec3d& point, const vector<std::pair<Transformation, enterprise_manager::Vec3d>>& transformations) {
-	for (Oint i = 0; i < transformations.size(); ++i) {
+	for (Ouint i = 0; i < transformations.size(); ++i) {
 		if (transformations[i].first == Translation) {
 			point += transformations[i].second;
 		}
@@ -192,3 +1254,14 @@ void FileManager::_Transform(enterprise_manager::Vec3d& point, const vector<std:
 		}
 	}
 }
+
+/* static */ void FileManager::_WriteNumber(string& buffer, Odouble value) {
+	//whole numbers below a million are printed as integers by the default format
+	if (value == floor(value) && fabs(value) < 1e6 && !(value == 0 && signbit(value))) {
+		buffer += to_string((long long)value);
+		return;
+	}
+	char text[32];
+	Oint length = sprintf(text, "%g", value);
+	buffer.append(text, length);
+}
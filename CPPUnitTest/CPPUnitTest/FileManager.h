@@ -8,17 +8,57 @@ public:
 	FileManager(void);
 	~FileManager(void);
 
+	// Read the objects of a text file. The file is mapped and its objects are
+	// parsed in place, in parallel with the threads of the current context.
 	void ReadTestFile(const std::string& path, vector<enterprise_manager::Object<Odouble>*>& objects);
 	void WriteTestFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName);
 	void ClearObjects(vector<enterprise_manager::Object<Odouble>*>& objects);
 
+	// Binary mesh files hold a header, a table with one record per object and, for
+	// each object, the coordinate, polygon offset and vertex index blocks of Mesh
+	// followed by optional metadata text. The reader maps the file and builds the
+	// objects straight from the blocks. The metadata of object i is metadata[i].
+	void ReadBinaryFile(const std::string& path, vector<enterprise_manager::Object<Odouble>*>& objects, vector<std::string>* metadata = NULL);
+	void WriteBinaryFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName, const vector<std::string>* metadata = NULL);
+
+	// Exchange formats, read in place from the mapped file into the arrays of
+	// Object::CreateFromIndexedPolygons. Each "o" section of an OBJ file, each
+	// solid of an ASCII STL file and a whole binary STL or PLY file become one
+	// object. STL triangles are welded at equal points while they are read and
+	// those whose corners are welded together are dropped. PLY files must be binary.
+	void ReadObjFile(const std::string& path, vector<enterprise_manager::Object<Odouble>*>& objects);
+	void ReadStlFile(const std::string& path, vector<enterprise_manager::Object<Odouble>*>& objects);
+	void ReadPlyFile(const std::string& path, vector<enterprise_manager::Object<Odouble>*>& objects);
+
+	// The writers take the points and face set indexes of the objects from GetCoords
+	// and GetFaceSetIndexes. OBJ and ASCII STL keep all digits of the coordinates,
+	// binary STL stores floats and the polygons as fans of triangles, PLY is
+	// written as binary with double coordinates. Binary STL and PLY hold all
+	// objects as a single mesh.
+	void WriteObjFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName);
+	void WriteStlFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName, Obool binary = true);
+	void WritePlyFile(vector<enterprise_manager::Object<Odouble>*>& objects, const std::string& fileName);
+
 private:
 	enum Transformation { Translation, Scale };
 
-	void _ParseObjectHeader(std::string& headerString);
-	void _ParseFacetHeader(std::string& facetString);
-	void _ParsePoint(std::string& point, enterprise_manager::Vec3d& vertex);
+	// The lines of one object of a text file, from its "Object" line up to the next one.
+	struct TextObject {
+		const char* begin;
+		const char* end;
+		enterprise_manager::Object<Odouble>* object;
+		// The line which could not be parsed, or NULL.
+		const char* error;
+	};
+
+	static void _ParseObject(TextObject& text);
+	// Parse the number at begin, skipping leading blanks, and return the position after it or NULL.
+	static const char* _ParseNumber(const char* begin, const char* end, Odouble& value);
+	// Parse three numbers separated by "; " and return the position after them or NULL.
+	static const char* _ParsePoint(const char* begin, const char* end, enterprise_manager::Vec3d& vertex);
 
-	void _Transform(enterprise_manager::Vec3d& point, const vector<std::pair<Transformation, enterprise_manager::Vec3d>>& transformations);
+	static void _Transform(enterprise_manager::Vec3d& point, const vector<std::pair<Transformation, enterprise_manager::Vec3d>>& transformations);
+	// Append the number as ostream would print it with the default precision.
+	static void _WriteNumber(std::string& buffer, Odouble value);
 };
 
@@ -1,6 +1,14 @@
 #include "CSGTest.h"
+#include "CSGBenchmark.h"
+#include <cstring>
+
+int main(int argc, char* argv[]) {
+	if (argc > 1 && strcmp(argv[1], "benchmark") == 0) {
+		CSGBenchmark benchmark;
+		benchmark.Run();
+		return 0;
+	}
 
-int main() {
 	CSGTest test;
 	test.DetectIntersection();
 	test.IntersectionTest();
@@ -9,7 +17,20 @@ int main() {
 	test.ToleranceTest();
 	test.SplitTest();
 	test.SubdivideTest();
+	test.ConcurrencyTest();
+	test.CloneTest();
+	test.MultipleDifferenceTest();
+	test.MultipleUnionTest();
+	test.PlacementTest();
+	test.ArrangementTest();
+	test.TransformTest();
+	test.BinaryFileTest();
+	test.ExchangeTest();
+	test.StatisticsTest();
+	test.TraceTest();
+	test.BudgetTest();
+	test.ThreadTest();
 	std::cin.get();
 
-	return 0;
+	return test.failures() == 0 ? 0 : 1;
 }
\ No newline at end of file
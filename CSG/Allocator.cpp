@@ -0,0 +1,6 @@
+#include "config.h"
+#include "Allocator.h"
+
+namespace enterprise_manager {
+
+} // namespace enterprise_manager
@@ -0,0 +1,74 @@
+#ifndef CSG_ALLOCATOR_H
+#define CSG_ALLOCATOR_H
+
+#include "config.h"
+#include <vector>
+#include <new>
+
+namespace enterprise_manager {
+
+	// The class Allocator provides the memory of the vertices and polygons of an
+	// Object. This implementation uses the heap for every element, derived classes
+	// may implement pools or arenas. An allocator must outlive the objects using it.
+	template <class T> class Allocator {
+	public:
+		Allocator();
+		virtual                 ~Allocator();
+
+		virtual void*           Allocate(Osize size);
+		virtual void            Free(void* memory, Osize size);
+
+		// Number of elements allocated and freed.
+		inline Ouint64          allocations() const;
+		inline Ouint64          frees() const;
+		// Number of allocations from the heap, for pools the number of blocks.
+		inline Ouint64          heapAllocations() const;
+		// Size of the elements allocated and not freed, e.g. for Context::Budget.
+		inline Ouint64          bytes() const;
+
+	protected:
+		Ouint64                 _allocations;
+		Ouint64                 _frees;
+		Ouint64                 _heapAllocations;
+		Ouint64                 _bytes;
+	};
+
+	// The class PoolAllocator carves the elements from large blocks by bumping a
+	// pointer. Freed elements are kept in a free list per size and reused, the
+	// blocks are only released all at once when the allocator is destroyed.
+	template <class T> class PoolAllocator : public Allocator<T> {
+	public:
+		PoolAllocator();
+		virtual                 ~PoolAllocator();
+
+		virtual void*           Allocate(Osize size);
+		virtual void            Free(void* memory, Osize size);
+
+	private:
+		PoolAllocator(const PoolAllocator&);
+		PoolAllocator&          operator=(const PoolAllocator&);
+
+		enum {
+			ALIGNMENT = 16,
+			// Larger elements are allocated from the heap.
+			MAX_POOLED_SIZE = 1024,
+			// The blocks grow from the first to the maximum size, so small objects stay small.
+			FIRST_BLOCK_SIZE = 4096,
+			MAX_BLOCK_SIZE = 1024 * 1024
+		};
+
+		static inline Osize     RoundedSize(Osize size);
+
+		std::vector<char*>      _block;
+		char*                   _next;
+		char*                   _end;
+		Osize                   _blockSize;
+		// Head of the list of freed elements for each size, linked through the elements.
+		void*                   _freeList[MAX_POOLED_SIZE / ALIGNMENT + 1];
+	};
+
+} // namespace enterprise_manager
+
+#include "Allocator.inl"
+
+#endif // CSG_ALLOCATOR_H
@@ -0,0 +1,124 @@
+namespace enterprise_manager {
+
+	template <class T>
+	Allocator<T>::Allocator()
+		: _allocations(0),
+		_frees(0),
+		_heapAllocations(0),
+		_bytes(0) {}
+
+	template <class T>
+	/* virtual */
+	Allocator<T>::~Allocator() {}
+
+	template <class T>
+	/* virtual */ void*
+		Allocator<T>::Allocate(Osize size) {
+			++_allocations;
+			++_heapAllocations;
+			_bytes += size;
+			return ::operator new(size);
+		}
+
+	template <class T>
+	/* virtual */ void
+		Allocator<T>::Free(void* memory, Osize size) {
+			++_frees;
+			_bytes -= size;
+			::operator delete(memory);
+		}
+
+	template <class T>
+	inline Ouint64
+		Allocator<T>::allocations() const {
+			return _allocations;
+		}
+
+	template <class T>
+	inline Ouint64
+		Allocator<T>::frees() const {
+			return _frees;
+		}
+
+	template <class T>
+	inline Ouint64
+		Allocator<T>::heapAllocations() const {
+			return _heapAllocations;
+		}
+
+	template <class T>
+	inline Ouint64
+		Allocator<T>::bytes() const {
+			return _bytes;
+		}
+
+	template <class T>
+	PoolAllocator<T>::PoolAllocator()
+		: _next(NULL),
+		_end(NULL),
+		_blockSize(FIRST_BLOCK_SIZE) {
+		for (Ouint i = 0; i <= MAX_POOLED_SIZE / ALIGNMENT; ++i) {
+			_freeList[i] = NULL;
+		}
+	}
+
+	template <class T>
+	/* virtual */
+	PoolAllocator<T>::~PoolAllocator() {
+		for (Ouint i = 0; i < _block.size(); ++i) {
+			::operator delete(_block[i]);
+		}
+	}
+
+	template <class T>
+	/* static */ inline Osize
+		PoolAllocator<T>::RoundedSize(Osize size) {
+			return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		}
+
+	template <class T>
+	/* virtual */ void*
+		PoolAllocator<T>::Allocate(Osize size) {
+			size = RoundedSize(size);
+			if (size > MAX_POOLED_SIZE)
+				return Allocator<T>::Allocate(size);
+
+			++this->_allocations;
+			this->_bytes += size;
+			void*& freeList = _freeList[size / ALIGNMENT];
+			if (freeList) {
+				void* memory = freeList;
+				freeList = *(void**)memory;
+				return memory;
+			}
+
+			if (_next == NULL || size > (Osize)(_end - _next)) {
+				_next = (char*)::operator new(_blockSize);
+				_end = _next + _blockSize;
+				_block.push_back(_next);
+				++this->_heapAllocations;
+				if (_blockSize < MAX_BLOCK_SIZE)
+					_blockSize *= 2;
+			}
+			void* memory = _next;
+			_next += size;
+			return memory;
+		}
+
+	template <class T>
+	/* virtual */ void
+		PoolAllocator<T>::Free(void* memory, Osize size) {
+			size = RoundedSize(size);
+			if (size > MAX_POOLED_SIZE) {
+				Allocator<T>::Free(memory, size);
+				return;
+			}
+
+			++this->_frees;
+			this->_bytes -= size;
+			void*& freeList = _freeList[size / ALIGNMENT];
+			*(void**)memory = freeList;
+			freeList = memory;
+		}
+
+} // namespace enterprise_manager
@@ -0,0 +1,71 @@
+#ifndef CSG_BOUNDINGVOLUMEHIERARCHY_H
+#define CSG_BOUNDINGVOLUMEHIERARCHY_H
+
+#include "Vertex.h"
+#include "Extent.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace enterprise_manager {
+
+	template <class T> class Polygon;
+
+	// The class BoundingVolumeHierarchy is a binary tree of extents built over the
+	// polygons of an Object. It is used to find the polygons whose extents overlap
+	// a given extent without testing every polygon of the object.
+	template <class T> class BoundingVolumeHierarchy {
+	public:
+		BoundingVolumeHierarchy();
+		virtual                 ~BoundingVolumeHierarchy();
+
+		// Build the hierarchy over the extents of the polygons.
+		void                    Build(const std::vector<Polygon<T>*>& polygons);
+		// Build the hierarchy over the extents min[i]-max[i] of the polygons.
+		void                    Build(const std::vector<Vec3<T> >& min, const std::vector<Vec3<T> >& max);
+
+		// Remove all nodes.
+		void                    Clear();
+
+		inline Obool            empty() const;
+
+		// Collect the indexes of the polygons whose extents overlap the specified
+		// extent. The indexes are returned in ascending order, so iterating over
+		// them visits the polygons in the same order as iterating over the polygon list.
+		void                    Query(const Extent<T>& extent, std::vector<Oint>& polygonIndexes) const;
+
+		// Collect the indexes of the polygons whose extents, enlarged by margin on
+		// each side, are hit by the ray origin + dir*t with t >= minDistance. The
+		// indexes are returned in ascending order.
+		void                    QueryRay(const Vec3<T>& origin, const Vec3<T>& dir, T minDistance, T margin, std::vector<Oint>& polygonIndexes) const;
+
+	private:
+		struct Node {
+			Vec3<T>             min;
+			Vec3<T>             max;
+			// For inner nodes: index of the second child (the first child follows the node).
+			// For leaves: index of the first polygon in _polygonIndex.
+			Oint                offset;
+			// Number of polygons in the leaf, 0 for inner nodes.
+			Oint                count;
+		};
+
+		enum { MAX_LEAF_SIZE = 4 };
+
+		Oint                    BuildNode(Oint first, Oint last, std::vector<Vec3<T> >& centers);
+
+		static inline Obool     Overlap(const Vec3<T>& minA, const Vec3<T>& maxA, const Vec3<T>& minB, const Vec3<T>& maxB);
+		static inline Obool     HitByRay(const Vec3<T>& min, const Vec3<T>& max, const Vec3<T>& origin, const Vec3<T>& dir, T minDistance, T margin);
+
+		std::vector<Node>       _node;
+		std::vector<Oint>       _polygonIndex;
+		// Extents of the polygons by polygon index.
+		std::vector<Vec3<T> >   _polygonMin;
+		std::vector<Vec3<T> >   _polygonMax;
+	};
+
+} // namespace enterprise_manager
+
+#include "BoundingVolumeHierarchy.inl"
+
+#endif // CSG_BOUNDINGVOLUMEHIERARCHY_H
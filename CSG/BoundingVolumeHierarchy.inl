@@ -0,0 +1,199 @@
+namespace enterprise_manager {
+
+	template <class T>
+	BoundingVolumeHierarchy<T>::BoundingVolumeHierarchy() {}
+
+	template <class T>
+	/* virtual */
+	BoundingVolumeHierarchy<T>::~BoundingVolumeHierarchy() {}
+
+	template <class T>
+	inline Obool
+		BoundingVolumeHierarchy<T>::empty() const {
+			return _node.empty();
+		}
+
+	template <class T>
+	void
+		BoundingVolumeHierarchy<T>::Clear() {
+			_node.clear();
+			_polygonIndex.clear();
+			_polygonMin.clear();
+			_polygonMax.clear();
+		}
+
+	template <class T>
+	void
+		BoundingVolumeHierarchy<T>::Build(const std::vector<Polygon<T>*>& polygons) {
+			std::vector<Vec3<T> > min(polygons.size()), max(polygons.size());
+			for (Ouint i = 0; i < polygons.size(); ++i) {
+				min[i] = polygons[i]->extent().min();
+				max[i] = polygons[i]->extent().max();
+			}
+			Build(min, max);
+		}
+
+	template <class T>
+	void
+		BoundingVolumeHierarchy<T>::Build(const std::vector<Vec3<T> >& min, const std::vector<Vec3<T> >& max) {
+			Clear();
+			if (min.empty())
+				return;
+
+			_polygonMin = min;
+			_polygonMax = max;
+			std::vector<Vec3<T> > centers(min.size());
+			_polygonIndex.resize(min.size());
+			for (Ouint i = 0; i < min.size(); ++i) {
+				_polygonIndex[i] = i;
+				centers[i] = (min[i] + max[i]) * T(0.5);
+			}
+			// A binary tree with leaves of at least one polygon never has more than 2n - 1 nodes.
+			_node.reserve(2 * min.size());
+			BuildNode(0, (Oint)min.size(), centers);
+		}
+
+	template <class T>
+	Oint
+		BoundingVolumeHierarchy<T>::BuildNode(Oint first, Oint last, std::vector<Vec3<T> >& centers) {
+			Oint nodeIndex = (Oint)_node.size();
+			_node.push_back(Node());
+
+			Vec3<T> min = _polygonMin[_polygonIndex[first]];
+			Vec3<T> max = _polygonMax[_polygonIndex[first]];
+			Vec3<T> centerMin = centers[_polygonIndex[first]];
+			Vec3<T> centerMax = centerMin;
+			for (Oint i = first + 1; i < last; ++i) {
+				min.MinComp(_polygonMin[_polygonIndex[i]]);
+				max.MaxComp(_polygonMax[_polygonIndex[i]]);
+				centerMin.MinComp(centers[_polygonIndex[i]]);
+				centerMax.MaxComp(centers[_polygonIndex[i]]);
+			}
+			_node[nodeIndex].min = min;
+			_node[nodeIndex].max = max;
+
+			if (last - first <= MAX_LEAF_SIZE) {
+				_node[nodeIndex].offset = first;
+				_node[nodeIndex].count = last - first;
+				return nodeIndex;
+			}
+
+			//split at the median of the polygon centers along the longest axis
+			Vec3<T> size = centerMax - centerMin;
+			Oint axis = X;
+			if (size[Y] > size[axis])
+				axis = Y;
+			if (size[Z] > size[axis])
+				axis = Z;
+
+			Oint middle = first + (last - first) / 2;
+			std::nth_element(_polygonIndex.begin() + first, _polygonIndex.begin() + middle, _polygonIndex.begin() + last,
+				[&centers, axis](Oint a, Oint b) { return centers[a][axis] < centers[b][axis]; });
+
+			BuildNode(first, middle, centers);
+			Oint second = BuildNode(middle, last, centers);
+			_node[nodeIndex].offset = second;
+			_node[nodeIndex].count = 0;
+			return nodeIndex;
+		}
+
+	template <class T>
+	/* static */ inline Obool
+		BoundingVolumeHierarchy<T>::Overlap(const Vec3<T>& minA, const Vec3<T>& maxA, const Vec3<T>& minB, const Vec3<T>& maxB) {
+			//same test as Extent<T>::Overlap, so a node is never rejected when one of its polygons would overlap
+			if (Greater(minB[X], maxA[X]) || Greater(minA[X], maxB[X]))
+				return false;
+			if (Greater(minB[Y], maxA[Y]) || Greater(minA[Y], maxB[Y]))
+				return false;
+			if (Greater(minB[Z], maxA[Z]) || Greater(minA[Z], maxB[Z]))
+				return false;
+			return true;
+		}
+
+	template <class T>
+	void
+		BoundingVolumeHierarchy<T>::Query(const Extent<T>& extent, std::vector<Oint>& polygonIndexes) const {
+			polygonIndexes.clear();
+			if (_node.empty())
+				return;
+
+			Oint stack[64];
+			Oint stackSize = 0;
+			stack[stackSize++] = 0;
+			while (stackSize > 0) {
+				const Node& node = _node[stack[--stackSize]];
+				if (!Overlap(node.min, node.max, extent.min(), extent.max()))
+					continue;
+				if (node.count > 0) {
+					for (Oint i = node.offset; i < node.offset + node.count; ++i) {
+						Oint polygon = _polygonIndex[i];
+						if (Overlap(_polygonMin[polygon], _polygonMax[polygon], extent.min(), extent.max()))
+							polygonIndexes.push_back(polygon);
+					}
+				}
+				else {
+					stack[stackSize++] = node.offset;
+					stack[stackSize++] = (Oint)(&node - &_node[0]) + 1;
+				}
+			}
+			std::sort(polygonIndexes.begin(), polygonIndexes.end());
+		}
+
+	template <class T>
+	/* static */ inline Obool
+		BoundingVolumeHierarchy<T>::HitByRay(const Vec3<T>& min, const Vec3<T>& max, const Vec3<T>& origin, const Vec3<T>& dir, T minDistance, T margin) {
+			//slab test, the ray parameter range is clipped by the box on each axis
+			T nearDistance = minDistance;
+			T farDistance = std::numeric_limits<T>::max();
+			for (Oint axis = X; axis <= Z; ++axis) {
+				T low = min[axis] - margin;
+				T high = max[axis] + margin;
+				if (dir[axis] == T(0)) {
+					if (origin[axis] < low || origin[axis] > high)
+						return false;
+					continue;
+				}
+				T distanceLow = (low - origin[axis]) / dir[axis];
+				T distanceHigh = (high - origin[axis]) / dir[axis];
+				if (distanceLow > distanceHigh)
+					std::swap(distanceLow, distanceHigh);
+				if (distanceLow > nearDistance)
+					nearDistance = distanceLow;
+				if (distanceHigh < farDistance)
+					farDistance = distanceHigh;
+				if (nearDistance > farDistance)
+					return false;
+			}
+			return true;
+		}
+
+	template <class T>
+	void
+		BoundingVolumeHierarchy<T>::QueryRay(const Vec3<T>& origin, const Vec3<T>& dir, T minDistance, T margin, std::vector<Oint>& polygonIndexes) const {
+			polygonIndexes.clear();
+			if (_node.empty())
+				return;
+
+			Oint stack[64];
+			Oint stackSize = 0;
+			stack[stackSize++] = 0;
+			while (stackSize > 0) {
+				const Node& node = _node[stack[--stackSize]];
+				if (!HitByRay(node.min, node.max, origin, dir, minDistance, margin))
+					continue;
+				if (node.count > 0) {
+					for (Oint i = node.offset; i < node.offset + node.count; ++i) {
+						Oint polygon = _polygonIndex[i];
+						if (HitByRay(_polygonMin[polygon], _polygonMax[polygon], origin, dir, minDistance, margin))
+							polygonIndexes.push_back(polygon);
+					}
+				}
+				else {
+					stack[stackSize++] = node.offset;
+					stack[stackSize++] = (Oint)(&node - &_node[0]) + 1;
+				}
+			}
+			std::sort(polygonIndexes.begin(), polygonIndexes.end());
+		}
+
+} // namespace enterprise_manager
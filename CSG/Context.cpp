@@ -0,0 +1,24 @@
+#include "config.h"
+#include "Context.h"
+
+namespace enterprise_manager {
+
+	CancellationToken::CancellationToken()
+		: _cancelled(false) {}
+
+	void
+		CancellationToken::Cancel() {
+			_cancelled = true;
+		}
+
+	void
+		CancellationToken::Reset() {
+			_cancelled = false;
+		}
+
+	Obool
+		CancellationToken::cancelled() const {
+			return _cancelled;
+		}
+
+} // namespace enterprise_manager
@@ -0,0 +1,255 @@
+#ifndef CSG_CONTEXT_H
+#define CSG_CONTEXT_H
+
+#include "config.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace enterprise_manager {
+
+	template <class T> class ContextScope;
+	template <class T> class OperationScope;
+
+	// The class CancellationToken lets another thread abort the operations of the
+	// contexts it is set in, see Context::cancellation.
+	class CancellationToken {
+	public:
+		CancellationToken();
+
+		void                    Cancel();
+		void                    Reset();
+		Obool                   cancelled() const;
+
+	private:
+		CancellationToken(const CancellationToken&);
+		CancellationToken&      operator=(const CancellationToken&);
+
+		std::atomic<Obool>      _cancelled;
+	};
+
+	// The class Context carries the state of a CSG operation: the tolerances used
+	// by the comparison helpers, scratch buffers and statistics. Every thread has
+	// its own current context, so operations running in different threads with
+	// different contexts do not share any state.
+	template <class T> class Context {
+		friend class ContextScope<T>;
+		friend class OperationScope<T>;
+
+	public:
+		Context();
+		virtual                 ~Context();
+
+		// Tolerances, SetTolerance of Object derives them from the operands.
+		T                       tolerance;
+		T                       unitTolerance;
+		T                       epsilonValue;
+
+		// Number of threads the operations may use. With 1 everything runs on the
+		// calling thread.
+		Ouint                   threadCount;
+
+		// With arrangementSplit SplitBy of Object collects all the cuts of a polygon
+		// first and replaces the polygon by all its fragments at once, instead of
+		// subdividing it by one polygon of the other object after another. The
+		// fragments differ from those of the default subdivision.
+		Obool                   arrangementSplit;
+
+		// With detailedStatistics the operations also time their phases and fill in
+		// the detailed counters of statistics. Without it they only test the flag.
+		Obool                   detailedStatistics;
+
+		// Copy the tolerances, arrangementSplit, detailedStatistics, the budget with
+		// the deadline of the running operation, the cancellation token and the
+		// progress callback from the other context.
+		void                    CopySettings(const Context& other);
+
+		// Counters of the work done by the operations run in this context.
+		struct Statistics {
+			// The phases of a Boolean operation. The three SplitBy passes subdivide A by B,
+			// B by A and A by B again. The delete lists include marking the vertices and
+			// cleaning up includes the plane equations, Simplify and the extents.
+			enum Phase {
+				SET_TOLERANCE, SPLIT_FIRST, SPLIT_SECOND, SPLIT_THIRD, MAKE_CCW, PLACEMENT,
+				DELETE_LISTS, DELETE_POLYGONS, MERGE, CLEAN_UP, PHASE_COUNT
+			};
+			// Segment<T>::FACE_FACE_FACE + 1, the size of the table indexed by the
+			// intersection types of Segment.
+			static const Ouint  intersectionTypeCount = 43;
+
+			Statistics();
+			void                Clear();
+			void                Add(const Statistics& other);
+
+			// Count a subdivision of the Segment<T>::INTERSECTION_TYPE.
+			void                CountIntersectionType(Oint type);
+
+			static const char*  phaseName(Phase phase);
+
+			// Polygon pairs tested for intersection.
+			Ouint64             polygonPairs;
+			// Polygon pairs with overlapping extents left out before the intersection
+			// test, as the plane of one polygon has the other on one side.
+			Ouint64             separatedPairs;
+			// Polygons subdivided by another polygon.
+			Ouint64             subdivisions;
+			// Polygons classified by casting a ray.
+			Ouint64             rayCasts;
+			// Polygons tested against those rays.
+			Ouint64             rayPolygons;
+
+			// The detailed statistics, only filled in with detailedStatistics.
+			// Wall time of each phase.
+			Odouble             phaseNanoseconds[PHASE_COUNT];
+			// Extents of polygons tested against the extent of the other object, and
+			// polygon pairs whose extents overlap.
+			Ouint64             extentTests;
+			Ouint64             overlappingPairs;
+			// Subdivisions by the Segment<T>::INTERSECTION_TYPE of the segment of the
+			// subdivided polygon.
+			Ouint64             intersectionTypes[intersectionTypeCount];
+			// Vertices created by the subdivisions and the merge, and points for which
+			// an existing vertex was found instead.
+			Ouint64             createdVertices;
+			Ouint64             existingVertices;
+		};
+		Statistics              statistics;
+
+		// Limits of the operations run in this context, zero for none. An operation
+		// exceeding one of them, or whose cancellation token is cancelled, is aborted:
+		// it stops at the next check while splitting, after a subdivision or while
+		// classifying the polygons, and sets abortReason.
+		struct Budget {
+			Budget();
+
+			// Wall time of an operation in seconds, counted from its start.
+			Odouble             seconds;
+			// Polygons of an object being split.
+			Ouint               polygons;
+			// Bytes of the vertices and polygons of the operands, as counted by their allocators.
+			Ouint64             bytes;
+		};
+		Budget                  budget;
+
+		// Cancelled by another thread to abort the operations. Not owned.
+		const CancellationToken* cancellation;
+
+		// Called on the thread of the operation as it gets on, with the phase and the
+		// part of the phase done. The work of a phase is not known in advance, so the
+		// part may go down when a split pass creates polygons. The contexts of the
+		// branches of a multiple union take over the callback with CopySettings, so
+		// with several threads it is called by the branches on their own threads, at
+		// the same time, each with the phase and part of its own branch.
+		typedef void (*ProgressCallback)(typename Statistics::Phase phase, Odouble fraction, void* data);
+		ProgressCallback        progress;
+		void*                   progressData;
+		// The phase of the running operation, see PhaseTimer.
+		typename Statistics::Phase phase;
+
+		enum ABORT_REASON {
+			NOT_ABORTED = 0,
+			CANCELLED,
+			DEADLINE_PASSED,
+			POLYGON_LIMIT,
+			MEMORY_LIMIT,
+			// A polygon was split again and again without end.
+			SUBDIVISION_LOOP
+		};
+		// Why the last operation was aborted.
+		ABORT_REASON            abortReason;
+
+		inline Obool            aborted() const;
+
+		// Whether the operations have a budget or a cancellation token. Only then they
+		// copy their operands first, so that an aborted operation leaves them as they
+		// were. Without, the operations are only aborted by the limit of MAX_POLYGONS
+		// polygons or a subdivision loop, which clear objectA and set its failed flag.
+		inline Obool            limited() const;
+
+		// Test the cancellation token and the deadline and abort the operation if
+		// needed. Returns whether the operation is aborted.
+		Obool                   Check();
+
+		// Abort the operation, the first reason is kept.
+		void                    Abort(ABORT_REASON reason);
+
+		// Report the part of the current phase done to the progress callback.
+		inline void             ReportProgress(Odouble fraction);
+
+		// Scratch buffers reused by the operations, so the hot loops do not allocate.
+		// overlapPolygons is used by extent queries, rayPolygons by ray queries,
+		// the distances by the intersection test of two polygons and by the cuts of
+		// SplitBy with arrangementSplit.
+		std::vector<Oint>       overlapPolygons;
+		std::vector<Oint>       rayPolygons;
+		std::vector<T>          distancesA;
+		std::vector<T>          distancesB;
+
+		// The context installed on the calling thread by the innermost ContextScope,
+		// or the process wide default context if there is none. Operations running
+		// concurrently must not share the default context.
+		static inline Context&  current();
+
+	private:
+		static O_THREAD_LOCAL Context* _current;
+		static Context          _default;
+
+		// The deadline of the running operation, see OperationScope.
+		std::chrono::high_resolution_clock::time_point _deadline;
+		Obool                   _hasDeadline;
+		Ouint                   _operationDepth;
+	};
+
+	// The class PhaseTimer makes the phase the current phase of the context and
+	// reports its start to the progress callback. If the context collects detailed
+	// statistics, it adds the time from its construction to its destruction or to
+	// Stop to the phase.
+	template <class T> class PhaseTimer {
+	public:
+		PhaseTimer(Context<T>& context, typename Context<T>::Statistics::Phase phase);
+		virtual                 ~PhaseTimer();
+
+		void                    Stop();
+
+	private:
+		PhaseTimer(const PhaseTimer&);
+		PhaseTimer&             operator=(const PhaseTimer&);
+
+		Context<T>*             _context;
+		typename Context<T>::Statistics::Phase _phase;
+		std::chrono::high_resolution_clock::time_point _start;
+	};
+
+	// The class ContextScope installs a context as the current context of the
+	// calling thread for its lifetime. Scopes may be nested.
+	template <class T> class ContextScope {
+	public:
+		explicit ContextScope(Context<T>& context);
+		virtual                 ~ContextScope();
+
+	private:
+		ContextScope(const ContextScope&);
+		ContextScope&           operator=(const ContextScope&);
+
+		Context<T>*             _previous;
+	};
+
+	// The class OperationScope installs the context of an operation like
+	// ContextScope. The outermost scope of a context starts the operation: it
+	// clears abortReason and sets the deadline from the budget, unless the context
+	// took over the deadline of another one with CopySettings.
+	template <class T> class OperationScope : public ContextScope<T> {
+	public:
+		explicit OperationScope(Context<T>& context);
+		virtual                 ~OperationScope();
+
+	private:
+		Context<T>&             _context;
+		Obool                   _ownsDeadline;
+	};
+
+} // namespace enterprise_manager
+
+#include "Context.inl"
+
+#endif // CSG_CONTEXT_H
@@ -0,0 +1,215 @@
+namespace enterprise_manager {
+
+	template <class T>
+	O_THREAD_LOCAL Context<T>* Context<T>::_current = NULL;
+
+	template <class T>
+	Context<T> Context<T>::_default;
+
+	template <class T>
+	Context<T>::Context()
+		: tolerance(T(0.1) / 1000),
+		unitTolerance(T(0.0001)),
+		epsilonValue(std::numeric_limits<T>::epsilon()),
+		threadCount(1),
+		arrangementSplit(false),
+		detailedStatistics(false),
+		cancellation(NULL),
+		progress(NULL),
+		progressData(NULL),
+		phase(Statistics::SET_TOLERANCE),
+		abortReason(NOT_ABORTED),
+		_hasDeadline(false),
+		_operationDepth(0) {}
+
+	template <class T>
+	/* virtual */
+	Context<T>::~Context() {}
+
+	template <class T>
+	void
+		Context<T>::CopySettings(const Context& other) {
+			tolerance = other.tolerance;
+			unitTolerance = other.unitTolerance;
+			epsilonValue = other.epsilonValue;
+			arrangementSplit = other.arrangementSplit;
+			detailedStatistics = other.detailedStatistics;
+			budget = other.budget;
+			cancellation = other.cancellation;
+			progress = other.progress;
+			progressData = other.progressData;
+			_deadline = other._deadline;
+			_hasDeadline = other._hasDeadline;
+		}
+
+	template <class T>
+	inline Obool
+		Context<T>::aborted() const {
+			return abortReason != NOT_ABORTED;
+		}
+
+	template <class T>
+	inline Obool
+		Context<T>::limited() const {
+			return cancellation != NULL || budget.seconds > 0 || budget.polygons > 0 || budget.bytes > 0;
+		}
+
+	template <class T>
+	Obool
+		Context<T>::Check() {
+			if (abortReason != NOT_ABORTED)
+				return true;
+			if (cancellation != NULL && cancellation->cancelled())
+				Abort(CANCELLED);
+			else if (_hasDeadline && std::chrono::high_resolution_clock::now() > _deadline)
+				Abort(DEADLINE_PASSED);
+			return abortReason != NOT_ABORTED;
+		}
+
+	template <class T>
+	void
+		Context<T>::Abort(ABORT_REASON reason) {
+			if (abortReason == NOT_ABORTED)
+				abortReason = reason;
+		}
+
+	template <class T>
+	inline void
+		Context<T>::ReportProgress(Odouble fraction) {
+			if (progress != NULL)
+				progress(phase, fraction, progressData);
+		}
+
+	template <class T>
+	Context<T>::Budget::Budget()
+		: seconds(0),
+		polygons(0),
+		bytes(0) {}
+
+	template <class T>
+	/* static */ inline Context<T>&
+		Context<T>::current() {
+			Context* context = _current;
+			return context ? *context : _default;
+		}
+
+	template <class T>
+	Context<T>::Statistics::Statistics() {
+		Clear();
+	}
+
+	template <class T>
+	void
+		Context<T>::Statistics::Clear() {
+			polygonPairs = 0;
+			separatedPairs = 0;
+			subdivisions = 0;
+			rayCasts = 0;
+			rayPolygons = 0;
+			for (Ouint i = 0; i < PHASE_COUNT; ++i)
+				phaseNanoseconds[i] = 0;
+			extentTests = 0;
+			overlappingPairs = 0;
+			for (Ouint i = 0; i < intersectionTypeCount; ++i)
+				intersectionTypes[i] = 0;
+			createdVertices = 0;
+			existingVertices = 0;
+		}
+
+	template <class T>
+	void
+		Context<T>::Statistics::Add(const Statistics& other) {
+			polygonPairs += other.polygonPairs;
+			separatedPairs += other.separatedPairs;
+			subdivisions += other.subdivisions;
+			rayCasts += other.rayCasts;
+			rayPolygons += other.rayPolygons;
+			for (Ouint i = 0; i < PHASE_COUNT; ++i)
+				phaseNanoseconds[i] += other.phaseNanoseconds[i];
+			extentTests += other.extentTests;
+			overlappingPairs += other.overlappingPairs;
+			for (Ouint i = 0; i < intersectionTypeCount; ++i)
+				intersectionTypes[i] += other.intersectionTypes[i];
+			createdVertices += other.createdVertices;
+			existingVertices += other.existingVertices;
+		}
+
+	template <class T>
+	void
+		Context<T>::Statistics::CountIntersectionType(Oint type) {
+			if (type >= 0 && type < (Oint)intersectionTypeCount)
+				++intersectionTypes[type];
+		}
+
+	template <class T>
+	/* static */ const char*
+		Context<T>::Statistics::phaseName(Phase phase) {
+			static const char* name[PHASE_COUNT] = {
+				"set tolerance", "split 1", "split 2", "split 3", "make ccw", "placement",
+				"delete lists", "delete", "merge", "clean up"
+			};
+			return phase < PHASE_COUNT ? name[phase] : "";
+		}
+
+	template <class T>
+	PhaseTimer<T>::PhaseTimer(Context<T>& context, typename Context<T>::Statistics::Phase phase)
+		: _context(context.detailedStatistics ? &context : NULL),
+		_phase(phase) {
+		context.phase = phase;
+		context.ReportProgress(0);
+		if (_context)
+			_start = std::chrono::high_resolution_clock::now();
+	}
+
+	template <class T>
+	/* virtual */
+	PhaseTimer<T>::~PhaseTimer() {
+		Stop();
+	}
+
+	template <class T>
+	void
+		PhaseTimer<T>::Stop() {
+			if (!_context)
+				return;
+			_context->statistics.phaseNanoseconds[_phase] += std::chrono::duration<Odouble, std::nano>(std::chrono::high_resolution_clock::now() - _start).count();
+			_context = NULL;
+		}
+
+	template <class T>
+	ContextScope<T>::ContextScope(Context<T>& context)
+		: _previous(Context<T>::_current) {
+		Context<T>::_current = &context;
+	}
+
+	template <class T>
+	/* virtual */
+	ContextScope<T>::~ContextScope() {
+		Context<T>::_current = _previous;
+	}
+
+	template <class T>
+	OperationScope<T>::OperationScope(Context<T>& context)
+		: ContextScope<T>(context),
+		_context(context),
+		_ownsDeadline(false) {
+		if (context._operationDepth++ > 0)
+			return;
+		context.abortReason = Context<T>::NOT_ABORTED;
+		if (!context._hasDeadline && context.budget.seconds > 0) {
+			std::chrono::duration<Odouble> seconds(context.budget.seconds);
+			context._deadline = std::chrono::high_resolution_clock::now() + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(seconds);
+			context._hasDeadline = true;
+			_ownsDeadline = true;
+		}
+	}
+
+	template <class T>
+	/* virtual */
+	OperationScope<T>::~OperationScope() {
+		--_context._operationDepth;
+		if (_ownsDeadline)
+			_context._hasDeadline = false;
+	}
+
+} // namespace enterprise_manager
@@ -3,6 +3,11 @@
 
 #include <math.h>
 #include <assert.h>
+#if defined(O_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(O_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
 
 namespace enterprise_manager {
 
@@ -330,6 +335,13 @@ namespace enterprise_manager {
 		  */
 		void                  MultVec4ByMatrix(T vector[4], T result[4]) const;
 
+		/**Multiply an array of points with the matrix, as Vec3<T>::operator*= does
+		  for each of them. The double and float versions use vector instructions.
+		  @param coords the x, y and z of the points, which are replaced by the result
+		  @param count the number of points
+		  */
+		void                  TransformPoints(T* coords, Osize count) const;
+
 		/** Transpose the matrix
 		  @return   reference to this matrix after it has been transposed
 		  */
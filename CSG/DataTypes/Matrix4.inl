@@ -1996,5 +1996,146 @@ namespace enterprise_manager {
 			}
 		}
 
-} // namespace enterprise_manager
+	template <class T>
+	void
+		Matrix4<T>::TransformPoints(T* coords, Osize count) const {
+			for (Osize i = 0; i < count; ++i, coords += 3) {
+				T tmp1 = coords[X] * _elements[a00] +
+					coords[Y] * _elements[a10] +
+					coords[Z] * _elements[a20] + _elements[a30];
+
+				T tmp2 = coords[X] * _elements[a01] +
+					coords[Y] * _elements[a11] +
+					coords[Z] * _elements[a21] + _elements[a31];
+
+				T tmp3 = coords[X] * _elements[a02] +
+					coords[Y] * _elements[a12] +
+					coords[Z] * _elements[a22] + _elements[a32];
+
+				T tmp4 = coords[X] * _elements[a03] +
+					coords[Y] * _elements[a13] +
+					coords[Z] * _elements[a23] + _elements[a33];
+
+				if (tmp4 != 1.0f) {
+					tmp4 = 1.0f / tmp4;
+					tmp1 *= tmp4;
+					tmp2 *= tmp4;
+					tmp3 *= tmp4;
+				}
+				coords[X] = tmp1;
+				coords[Y] = tmp2;
+				coords[Z] = tmp3;
+			}
+		}
+
+	// The vector versions keep the rows of the matrix in registers, so a point is
+	// x * row0 + y * row1 + z * row2 + row3 with the sums in the same order as above.
+#if defined(O_SIMD_AVX2)
+	template <>
+	inline void
+		Matrix4<double>::TransformPoints(double* coords, Osize count) const {
+			const __m256d row0 = _mm256_loadu_pd(&_elements[a00]);
+			const __m256d row1 = _mm256_loadu_pd(&_elements[a10]);
+			const __m256d row2 = _mm256_loadu_pd(&_elements[a20]);
+			const __m256d row3 = _mm256_loadu_pd(&_elements[a30]);
+			const __m256d one = _mm256_set1_pd(1.0);
+			for (Osize i = 0; i < count; ++i, coords += 3) {
+				__m256d point = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+					_mm256_mul_pd(_mm256_set1_pd(coords[X]), row0),
+					_mm256_mul_pd(_mm256_set1_pd(coords[Y]), row1)),
+					_mm256_mul_pd(_mm256_set1_pd(coords[Z]), row2)), row3);
+				__m256d w = _mm256_permute4x64_pd(point, 0xFF);
+				if (_mm256_movemask_pd(_mm256_cmp_pd(w, one, _CMP_NEQ_UQ)))
+					point = _mm256_mul_pd(point, _mm256_div_pd(one, w));
+				_mm_storeu_pd(coords, _mm256_castpd256_pd128(point));
+				_mm_store_sd(coords + Z, _mm256_extractf128_pd(point, 1));
+			}
+		}
+
+	template <>
+	inline void
+		Matrix4<float>::TransformPoints(float* coords, Osize count) const {
+			// Two points at a time, one in each half of the register.
+			const __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&_elements[a00]));
+			const __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&_elements[a10]));
+			const __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&_elements[a20]));
+			const __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&_elements[a30]));
+			const __m256 one = _mm256_set1_ps(1.0f);
+			Osize i = 0;
+			for (; i + 2 <= count; i += 2, coords += 6) {
+				__m256 point = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(_mm256_setr_ps(coords[0], coords[0], coords[0], coords[0], coords[3], coords[3], coords[3], coords[3]), row0),
+					_mm256_mul_ps(_mm256_setr_ps(coords[1], coords[1], coords[1], coords[1], coords[4], coords[4], coords[4], coords[4]), row1)),
+					_mm256_mul_ps(_mm256_setr_ps(coords[2], coords[2], coords[2], coords[2], coords[5], coords[5], coords[5], coords[5]), row2)), row3);
+				__m256 w = _mm256_permute_ps(point, 0xFF);
+				if (_mm256_movemask_ps(_mm256_cmp_ps(w, one, _CMP_NEQ_UQ)))
+					point = _mm256_mul_ps(point, _mm256_div_ps(one, w));
+				float result[8];
+				_mm256_storeu_ps(result, point);
+				coords[0] = result[0];
+				coords[1] = result[1];
+				coords[2] = result[2];
+				coords[3] = result[4];
+				coords[4] = result[5];
+				coords[5] = result[6];
+			}
+			if (i < count) {
+				__m128 point = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(_mm_set1_ps(coords[X]), _mm256_castps256_ps128(row0)),
+					_mm_mul_ps(_mm_set1_ps(coords[Y]), _mm256_castps256_ps128(row1))),
+					_mm_mul_ps(_mm_set1_ps(coords[Z]), _mm256_castps256_ps128(row2))), _mm256_castps256_ps128(row3));
+				__m128 w = _mm_shuffle_ps(point, point, 0xFF);
+				if (_mm_cvtss_f32(w) != 1.0f)
+					point = _mm_mul_ps(point, _mm_div_ps(_mm_set1_ps(1.0f), w));
+				_mm_storel_pi(reinterpret_cast<__m64*>(coords), point);
+				_mm_store_ss(coords + Z, _mm_movehl_ps(point, point));
+			}
+		}
+#elif defined(O_SIMD_SSE2)
+	template <>
+	inline void
+		Matrix4<double>::TransformPoints(double* coords, Osize count) const {
+			// x and y in one register, z and w in the other.
+			const __m128d row0xy = _mm_loadu_pd(&_elements[a00]), row0zw = _mm_loadu_pd(&_elements[a02]);
+			const __m128d row1xy = _mm_loadu_pd(&_elements[a10]), row1zw = _mm_loadu_pd(&_elements[a12]);
+			const __m128d row2xy = _mm_loadu_pd(&_elements[a20]), row2zw = _mm_loadu_pd(&_elements[a22]);
+			const __m128d row3xy = _mm_loadu_pd(&_elements[a30]), row3zw = _mm_loadu_pd(&_elements[a32]);
+			for (Osize i = 0; i < count; ++i, coords += 3) {
+				const __m128d x = _mm_set1_pd(coords[X]);
+				const __m128d y = _mm_set1_pd(coords[Y]);
+				const __m128d z = _mm_set1_pd(coords[Z]);
+				__m128d xy = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x, row0xy), _mm_mul_pd(y, row1xy)), _mm_mul_pd(z, row2xy)), row3xy);
+				__m128d zw = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x, row0zw), _mm_mul_pd(y, row1zw)), _mm_mul_pd(z, row2zw)), row3zw);
+				__m128d w = _mm_unpackhi_pd(zw, zw);
+				if (_mm_cvtsd_f64(w) != 1.0) {
+					w = _mm_div_pd(_mm_set1_pd(1.0), w);
+					xy = _mm_mul_pd(xy, w);
+					zw = _mm_mul_pd(zw, w);
+				}
+				_mm_storeu_pd(coords, xy);
+				_mm_store_sd(coords + Z, zw);
+			}
+		}
+
+	template <>
+	inline void
+		Matrix4<float>::TransformPoints(float* coords, Osize count) const {
+			const __m128 row0 = _mm_loadu_ps(&_elements[a00]);
+			const __m128 row1 = _mm_loadu_ps(&_elements[a10]);
+			const __m128 row2 = _mm_loadu_ps(&_elements[a20]);
+			const __m128 row3 = _mm_loadu_ps(&_elements[a30]);
+			for (Osize i = 0; i < count; ++i, coords += 3) {
+				__m128 point = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(_mm_set1_ps(coords[X]), row0),
+					_mm_mul_ps(_mm_set1_ps(coords[Y]), row1)),
+					_mm_mul_ps(_mm_set1_ps(coords[Z]), row2)), row3);
+				__m128 w = _mm_shuffle_ps(point, point, 0xFF);
+				if (_mm_cvtss_f32(w) != 1.0f)
+					point = _mm_mul_ps(point, _mm_div_ps(_mm_set1_ps(1.0f), w));
+				_mm_storel_pi(reinterpret_cast<__m64*>(coords), point);
+				_mm_store_ss(coords + Z, _mm_movehl_ps(point, point));
+			}
+		}
+#endif
 
+} // namespace enterprise_manager
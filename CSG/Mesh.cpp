@@ -0,0 +1,6 @@
+#include "config.h"
+#include "Mesh.h"
+
+namespace enterprise_manager {
+
+} // namespace enterprise_manager
@@ -0,0 +1,99 @@
+#ifndef CSG_MESH_H
+#define CSG_MESH_H
+
+#include "Vertex.h"
+#include "Polygon.h"
+#include <vector>
+#include <unordered_map>
+
+namespace enterprise_manager {
+
+	// The class Mesh is a compact copy of the vertices and polygons of an Object
+	// stored as arrays: the points of the vertices, the vertex indexes of the
+	// polygons one after another with the offset of each polygon into them, and
+	// the plane equations, areas and extents of the polygons. Loops testing a
+	// point or a ray against many polygons read these arrays instead of following
+	// the vertex pointers of each polygon. The mesh is a snapshot, it must be
+	// rebuilt when the vertices or polygons of the object change.
+	template <class T> class Mesh {
+	public:
+		Mesh();
+		virtual                 ~Mesh();
+
+		// Copy the vertices and polygons. Polygon i of the mesh is polygons[i], a
+		// NULL polygon gets no vertices.
+		void                    Build(const std::vector<Vertex<T>*>& vertices, const std::vector<Polygon<T>*>& polygons);
+
+		// Remove all vertices and polygons.
+		void                    Clear();
+
+		inline Obool            empty() const;
+
+		// The points of the vertices in the order of the vertex list of the object.
+		inline const std::vector<Vec3<T> >&
+			coords() const;
+
+		// The vertex indexes of polygon i are indexes()[offsets()[i]] to indexes()[offsets()[i + 1] - 1].
+		inline const std::vector<Ouint>&
+			offsets() const;
+		inline const std::vector<Ouint>&
+			indexes() const;
+
+		inline Ouint            polygonCount() const;
+
+		// Number of vertices of polygon p.
+		inline Ouint            size(Ouint p) const;
+
+		inline const Vec3<T>&   normal(Ouint p) const;
+
+		inline T                d(Ouint p) const;
+
+		// The extents of the polygons.
+		inline const std::vector<Vec3<T> >&
+			extentMin() const;
+		inline const std::vector<Vec3<T> >&
+			extentMax() const;
+
+		// Same as Polygon<T>::IsMeaning for polygon p.
+		inline Obool            IsMeaning(Ouint p) const;
+
+		// Same as Polygon<T>::PlaneToPointDistance for polygon p.
+		inline T                PlaneToPointDistance(Ouint p, const Vec3<T>& point) const;
+
+		// Same as Polygon<T>::IntersectRayWithPlane for polygon p.
+		inline T                IntersectRayWithPlane(Ouint p, const Vec3<T>& rayOrigin, const Vec3<T>& rayDir) const;
+
+		// Same as Polygon<T>::FindRelativePosition for polygon p.
+		RELPOS_STATUS           FindRelativePosition(Ouint p, const Vec3<T>& point) const;
+
+		// Get the vertex indexes of the polygons, each polygon terminated by -1.
+		void                    GetFaceSetIndexes(std::vector<Oint>& coordIndex) const;
+
+	private:
+		// The points of the vertices of a polygon for Polygon<T>::RelativePosition.
+		struct IndexedPoints {
+			const Vec3<T>*      coord;
+			const Ouint*        index;
+
+			IndexedPoints(const Vec3<T>* coord, const Ouint* index) : coord(coord), index(index) {}
+
+			inline const Vec3<T>& operator[](Ouint i) const { return coord[index[i]]; }
+		};
+
+		std::vector<Vec3<T> >   _coord;
+		std::vector<Ouint>      _offset;
+		std::vector<Ouint>      _index;
+
+		// Plane equation ax+by+cz+d = 0 where (a,b,c) = normal, by polygon.
+		std::vector<Vec3<T> >   _normal;
+		std::vector<T>          _d;
+		std::vector<T>          _area;
+		std::vector<Vec3<T> >   _extentMin;
+		std::vector<Vec3<T> >   _extentMax;
+	};
+
+} // namespace enterprise_manager
+
+#include "Mesh.inl"
+
+#endif // CSG_MESH_H
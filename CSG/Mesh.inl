@@ -0,0 +1,167 @@
+namespace enterprise_manager {
+
+	template <class T>
+	Mesh<T>::Mesh() {}
+
+	template <class T>
+	/* virtual */
+	Mesh<T>::~Mesh() {}
+
+	template <class T>
+	void
+		Mesh<T>::Build(const std::vector<Vertex<T>*>& vertices, const std::vector<Polygon<T>*>& polygons) {
+			Clear();
+
+			std::unordered_map<const Vertex<T>*, Ouint> vertexMap;
+			vertexMap.reserve(vertices.size());
+			_coord.resize(vertices.size());
+			for (Ouint i = 0; i < vertices.size(); ++i) {
+				if (vertices[i]) {
+					_coord[i] = vertices[i]->point();
+					vertexMap[vertices[i]] = i;
+				}
+			}
+
+			Ouint polygonCount = (Ouint)polygons.size();
+			_offset.resize(polygonCount + 1);
+			_normal.resize(polygonCount);
+			_d.resize(polygonCount);
+			_area.resize(polygonCount);
+			_extentMin.resize(polygonCount);
+			_extentMax.resize(polygonCount);
+			_offset[0] = 0;
+			for (Ouint i = 0; i < polygonCount; ++i) {
+				const Polygon<T>* polygon = polygons[i];
+				if (polygon) {
+					const std::vector<Vertex<T>*>& vertex = polygon->vertex();
+					for (Ouint j = 0; j < vertex.size(); ++j) {
+						//a vertex which is not in the vertex list gets index 0, as in the former map lookup of GetFaceSetIndexes
+						typename std::unordered_map<const Vertex<T>*, Ouint>::const_iterator it = vertexMap.find(vertex[j]);
+						_index.push_back(it != vertexMap.end() ? it->second : 0);
+					}
+					_normal[i] = polygon->normal();
+					_d[i] = polygon->d();
+					_area[i] = polygon->Area();
+					_extentMin[i] = polygon->extent().min();
+					_extentMax[i] = polygon->extent().max();
+				}
+				_offset[i + 1] = (Ouint)_index.size();
+			}
+		}
+
+	template <class T>
+	void
+		Mesh<T>::Clear() {
+			_coord.clear();
+			_offset.clear();
+			_index.clear();
+			_normal.clear();
+			_d.clear();
+			_area.clear();
+			_extentMin.clear();
+			_extentMax.clear();
+		}
+
+	template <class T>
+	inline Obool
+		Mesh<T>::empty() const {
+			return _offset.empty();
+		}
+
+	template <class T>
+	inline const std::vector<Vec3<T> >&
+		Mesh<T>::coords() const {
+			return _coord;
+		}
+
+	template <class T>
+	inline const std::vector<Ouint>&
+		Mesh<T>::offsets() const {
+			return _offset;
+		}
+
+	template <class T>
+	inline const std::vector<Ouint>&
+		Mesh<T>::indexes() const {
+			return _index;
+		}
+
+	template <class T>
+	inline Ouint
+		Mesh<T>::polygonCount() const {
+			return (Ouint)_normal.size();
+		}
+
+	template <class T>
+	inline Ouint
+		Mesh<T>::size(Ouint p) const {
+			return _offset[p + 1] - _offset[p];
+		}
+
+	template <class T>
+	inline const Vec3<T>&
+		Mesh<T>::normal(Ouint p) const {
+			return _normal[p];
+		}
+
+	template <class T>
+	inline T
+		Mesh<T>::d(Ouint p) const {
+			return _d[p];
+		}
+
+	template <class T>
+	inline const std::vector<Vec3<T> >&
+		Mesh<T>::extentMin() const {
+			return _extentMin;
+		}
+
+	template <class T>
+	inline const std::vector<Vec3<T> >&
+		Mesh<T>::extentMax() const {
+			return _extentMax;
+		}
+
+	template <class T>
+	inline Obool
+		Mesh<T>::IsMeaning(Ouint p) const {
+			T val = abs(_area[p]);
+			if (val - Context<T>::current().tolerance <= Context<T>::current().epsilonValue)
+				return false;
+			return true;
+		}
+
+	template <class T>
+	inline T
+		Mesh<T>::PlaneToPointDistance(Ouint p, const Vec3<T>& point) const {
+			return (_normal[p] * point + _d[p]);
+		}
+
+	template <class T>
+	inline T
+		Mesh<T>::IntersectRayWithPlane(Ouint p, const Vec3<T>& rayOrigin, const Vec3<T>& rayDir) const {
+			//(rayOrigin + rayDir*t)*normal+d = 0
+			return -(rayOrigin * _normal[p] + _d[p]) / (rayDir * _normal[p]);
+		}
+
+	template <class T>
+	RELPOS_STATUS
+		Mesh<T>::FindRelativePosition(Ouint p, const Vec3<T>& point) const {
+			return Polygon<T>::RelativePosition(IndexedPoints(_coord.data(), _index.data() + _offset[p]), size(p), _normal[p], point);
+		}
+
+	template <class T>
+	void
+		Mesh<T>::GetFaceSetIndexes(std::vector<Oint>& coordIndex) const {
+			coordIndex.clear();
+			coordIndex.reserve(_index.size() + polygonCount());
+			for (Ouint i = 0; i < polygonCount(); ++i) {
+				if (_offset[i] == _offset[i + 1])
+					continue;
+				for (Ouint j = _offset[i]; j < _offset[i + 1]; ++j)
+					coordIndex.push_back((Oint)_index[j]);
+				coordIndex.push_back(-1);
+			}
+		}
+
+} // namespace enterprise_manager
@@ -4,11 +4,20 @@
 #include "Vertex.h"
 #include "Polygon.h"
 #include "Segment.h"
+#include "BoundingVolumeHierarchy.h"
+#include "PlaneTable.h"
+#include "Mesh.h"
+#include "VertexGrid.h"
+#include "Parallel.h"
+#include "Allocator.h"
+#include "Trace.h"
 #include <vector>
 #include <algorithm>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include "TriangulatedSurface.h"
+#include "DataTypes/Matrix4.h"
 
 namespace enterprise_manager {
 
@@ -20,41 +29,109 @@ namespace enterprise_manager {
 
 		Object();
 
+		// Create an object whose vertices and polygons are allocated by the
+		// specified allocator, which must outlive the object. Without an allocator
+		// the object uses its own pool.
+		explicit                    Object(Allocator<T>* allocator);
+
 		virtual                     ~Object();
 
+		// Set when an operation on the object was aborted without a budget or a
+		// cancellation token in its context, see Context::limited. The object is
+		// empty then.
 		bool                        failed;
 
+		// Set the tolerances of the current context from the size of the objects.
 		static void                 SetTolerance(Object& objectA, Object& objectB);
 
 		Obool                       HasValidTopology();
 
-		static Object*              CreateFromIndexedFaceSet(const std::vector<Vec3<T> >& coord, const std::vector<Oint>& coordIndex, Obool ccw, Obool convex);
+		static Object*              CreateFromIndexedFaceSet(const std::vector<Vec3<T> >& coord, const std::vector<Oint>& coordIndex, Obool ccw, Obool convex, Allocator<T>* allocator = NULL);
+		// Create an object from flat arrays laid out as in Mesh: coordCount points of
+		// three coordinates each, and the vertex indexes of polygon i in
+		// indexes[offsets[i]] to indexes[offsets[i + 1] - 1]. Polygons without
+		// vertices are skipped. The arrays are read once, e.g. from a mapped file.
+		static Object*              CreateFromIndexedPolygons(const T* coords, Ouint coordCount, const Ouint* offsets, const Ouint* indexes, Ouint polygonCount, Allocator<T>* allocator = NULL);
 
 		//for tesing purposes
 		static Object*              CreateFromVertices(vector<Vertex<T>*> vertices);
 
+		// Create a copy of the object. The vertices and polygons are copied with their
+		// plane equations and extents, nothing is recalculated.
+		Object*                     Clone(Allocator<T>* allocator = NULL) const;
+
 		// Create the union of two objects. After the operation objectA will contain
 		// the union (A U B), objectB will be an invalid object.
 		static void                 CreateUnion(Object& objectA, Object& objectB);
+		// Same as above, running the operation in the specified context. The context
+		// keeps the tolerances and statistics of the operation afterwards. If the
+		// operation is aborted by the budget or the cancellation token of the context,
+		// see Context::abortReason, both objects are left as they were.
+		static void                 CreateUnion(Object& objectA, Object& objectB, Context<T>& context);
+
+		// Unite several objects with objectA (A U B1 U B2 ...). The objects in objectsB
+		// are not changed, see Union below. An aborted operation leaves objectA as it was.
+		static void                 CreateUnion(Object& objectA, const std::vector<Object*>& objectsB);
+		static void                 CreateUnion(Object& objectA, const std::vector<Object*>& objectsB, Context<T>& context);
 
 		// Create the intersection of two objects. After the operation objectA will
 		// contain the intersection (A ^ B), objectB will be an invalid object.
 		static void                 CreateIntersection(Object& objectA, Object& objectB);
+		// Same as above, running the operation in the specified context. The context
+		// keeps the tolerances and statistics of the operation afterwards, and an
+		// aborted operation leaves the objects as CreateUnion does.
+		static void                 CreateIntersection(Object& objectA, Object& objectB, Context<T>& context);
 
 		// Create the difference of two objects. After the operation objectA will
 		// contain the difference (A - B), objectB will be an invalid object.
 		static void                 CreateDifference(Object& objectA, Object& objectB);
+		// Same as above, running the operation in the specified context. The context
+		// keeps the tolerances and statistics of the operation afterwards, and an
+		// aborted operation leaves the objects as CreateUnion does.
+		static void                 CreateDifference(Object& objectA, Object& objectB, Context<T>& context);
+
+		// Subtract several objects from objectA (A - B1 - B2 ...), e.g. the openings
+		// of a wall. Objects whose extents do not overlap are subtracted in one pass.
+		// Unlike above, the objects in objectsB are not changed. An aborted operation
+		// leaves objectA as it was.
+		static void                 CreateDifference(Object& objectA, const std::vector<Object*>& objectsB);
+		static void                 CreateDifference(Object& objectA, const std::vector<Object*>& objectsB, Context<T>& context);
+
+		// Create a new object containing the union, intersection or difference of two
+		// objects. The objects are not changed, the operation runs on clones of them.
+		// The caller owns the returned object, which is empty with the failed flag set
+		// if the operation is aborted.
+		static Object*              Union(const Object& objectA, const Object& objectB);
+		static Object*              Union(const Object& objectA, const Object& objectB, Context<T>& context);
+		// Create a new object containing the union of all objects. Objects near each
+		// other are united first and the partial results in a balanced tree, so no
+		// object takes part in more than log2(n) operations. Objects whose extents do
+		// not overlap are put together without splitting. Independent branches of the
+		// tree run in parallel when the context has several threads.
+		static Object*              Union(const std::vector<Object*>& objects);
+		static Object*              Union(const std::vector<Object*>& objects, Context<T>& context);
+		static Object*              Intersection(const Object& objectA, const Object& objectB);
+		static Object*              Intersection(const Object& objectA, const Object& objectB, Context<T>& context);
+		static Object*              Difference(const Object& objectA, const Object& objectB);
+		static Object*              Difference(const Object& objectA, const Object& objectB, Context<T>& context);
+		static Object*              Difference(const Object& objectA, const std::vector<Object*>& objectsB);
+		static Object*              Difference(const Object& objectA, const std::vector<Object*>& objectsB, Context<T>& context);
 
 		void                        GetFaceSetIndexes(std::vector<Oint>& coordIndex) const;
 
 		void                        GetCoords(std::vector<Vec3<CSGReal> >& coord) const;
 
+		// Copy the vertices and polygons into the arrays of mesh, e.g. to export the
+		// object without converting the polygons one by one. Reusing the same mesh
+		// keeps its memory.
+		void                        GetMesh(Mesh<T>& mesh) const;
+
 		void                        Transform(const Matrix4<T>& matrix);
 
 		inline const Extent<T>&
 			extent() const;
-		// Split this object by ObjectB.
-		void                        SplitBy(const Object& objectB);
+		// Split this object by ObjectB. Returns the number of subdivisions.
+		Ouint                       SplitBy(const Object& objectB);
 
 		// Split ObjectA and ObjectB
 		static  void                SubdivideObjects(Object& objectA, Object& objectB);
@@ -79,10 +156,117 @@ namespace enterprise_manager {
 
 		inline const std::vector<Polygon<T>*>&
 			polygon() const;
+
+		// The allocator of the vertices and polygons, e.g. to read the allocation counts.
+		inline const Allocator<T>&
+			allocator() const;
 	private:
+		Object(const Object&);
+		Object&                     operator=(const Object&);
+
+		// Allocate and free vertices and polygons through the allocator of the object.
+		Vertex<T>*                  NewVertex(const Vec3<T>& point);
+		Polygon<T>*                 NewPolygon(const std::vector<Vertex<T>*>& vertices, Oint index);
+		Polygon<T>*                 NewPolygon(const Polygon<T>& original, const std::vector<Vertex<T>*>& vertices);
+		Polygon<T>*                 NewPolygon(const std::vector<Vertex<T>*>& vertices, Oint index, const Polygon<T>& original);
+		void                        DeleteVertex(Vertex<T>* vertex);
+		void                        DeletePolygon(Polygon<T>* polygon);
 
 		void                        CalculateExtents();
 
+		// Delete all vertices and polygons.
+		void                        Clear();
+
+		// Copy the vertices and polygons of objectB to the end of the lists of this
+		// object. Vertices at the same point are not merged.
+		void                        Append(const Object& objectB);
+
+		// The operations of CreateUnion, CreateIntersection and CreateDifference in
+		// the current context. They return early, leaving the objects half done, if
+		// the operation is aborted.
+		static void                 RunUnion(Object& objectA, Object& objectB);
+		static void                 RunIntersection(Object& objectA, Object& objectB);
+		static void                 RunDifference(Object& objectA, Object& objectB);
+
+		// Finish an operation on the object which may have been aborted. With a copy
+		// taken before the operation the object gets its polygons back, without it is
+		// cleared and flagged as failed. The copy is deleted.
+		static void                 EndOperation(Object& object, Object* copy);
+
+		// Abort the operation of the current context if this object has more polygons
+		// than the budget allows, MAX_POLYGONS without one, or if the vertices and
+		// polygons of this object and objectB take more bytes than the budget.
+		// Returns whether the operation is aborted.
+		Obool                       ExceedsBudget(const Object& objectB);
+
+		// How two objects without intersecting polygons lie to each other.
+		enum PLACEMENT_TYPE {
+			CROSSING = 0,
+			APART,
+			A_INSIDE_B,
+			B_INSIDE_A
+		};
+
+		// Split the objects as SubdivideObjects does and return CROSSING, unless no
+		// polygons of the objects intersect. Then nothing is split and the placement
+		// of the objects is returned, so the operations can take the result from the
+		// operands directly. Objects touching each other are CROSSING.
+		static PLACEMENT_TYPE       SubdivideOrPlace(Object& objectA, Object& objectB);
+
+		// Run the second and third pass of SubdivideObjects after objectA was split by
+		// objectB. If the first pass was complete, the third pass tests the polygons
+		// objectA had before it only against the polygons of objectB created by the
+		// second pass, all other pairs were tested by the first pass already.
+		static void                 FinishSubdivision(Object& objectA, Object& objectB, Obool firstPassComplete);
+
+		// Find the placement of objects whose polygons do not intersect from the
+		// position of one polygon of each shell. The hierarchies must not be built.
+		static PLACEMENT_TYPE       FindPlacement(Object& objectA, Object& objectB);
+
+		// Return INSIDE or OUTSIDE if every shell of this object, polygons connected
+		// through their vertices, lies on that side of objectB, otherwise UNKNOWN.
+		// The polygons must not intersect or touch objectB, so one polygon of a shell
+		// tells for the whole shell. The hierarchies of both objects must be built.
+		RELPOS_STATUS               FindShellPosition(const Object& objectB) const;
+
+		// Test if a vertex of objectB lies on the surface of this object. The
+		// hierarchy of this object must be built.
+		Obool                       HasVertexOnSurface(const Object& objectB) const;
+
+		// Unite objects[first, last) and return the result, which is one of the objects.
+		// The others are deleted. The objects in the range are reordered.
+		static Object*              UnionTree(std::vector<Object*>& objects, Ouint first, Ouint last);
+
+		// Find axis aligned planes between the extents of the objects, so that every
+		// object is alone in one of the cells the planes form if possible. The objects
+		// in [first, last) are reordered. A plane is a pair of axis and coordinate.
+		static void                 FindSeparatingPlanes(std::vector<const Object*>& objects, Ouint first, Ouint last, std::vector<std::pair<Oint, T> >& planes);
+
+		// The polygons split by SplitByPlanes. original holds the vertices of each
+		// polygon split, part the vertices of the parts it was split into and
+		// partOrigin the polygon in original each part comes from.
+		struct PlaneSplits {
+			std::vector<std::vector<Vertex<T>*> > original;
+			std::vector<std::vector<Vertex<T>*> > part;
+			std::vector<Ouint>      partOrigin;
+		};
+
+		// Split the convex polygons which cross the planes, pairs of axis and
+		// coordinate, into parts. Concave polygons are left whole, and so is every
+		// polygon sharing a crossing edge with a polygon left whole, so no vertex
+		// created on a plane lies in the middle of the edge of another polygon.
+		void                        SplitByPlanes(const std::vector<std::pair<Oint, T> >& planes, PlaneSplits& splits);
+
+		// Split the polygons which cross the plane point[axis] = value as
+		// SplitByPlanes does. origin is the index into original of each polygon
+		// split before, -1 for the others.
+		void                        SplitByPlane(Oint axis, T value, std::vector<Oint>& origin, std::vector<std::vector<Vertex<T>*> >& original);
+
+		// Merge the parts of each polygon split by SplitByPlanes back into one polygon
+		// if all of them are still there unchanged. The vertices created on the
+		// planes are left out of the merged polygon unless other polygons use them.
+		void                        MergePlaneSplits(const PlaneSplits& splits);
+
 		// Merge the polygons og objectB into this object.
 		void                        Merge(const Object& objectB);
 
@@ -93,8 +277,15 @@ namespace enterprise_manager {
 		inline const std::vector<Vertex<T>*>&
 			vertex() const;
 
+		// Find the status of polygonA relative to objectB, from its vertices if possible.
+		RELPOS_STATUS               ClassifyPolygon(const Polygon<T>& polygonA, const Object& objectB) const;
+
 		std::vector<Oint>           CreateDeleteList(Ouint deleteMask, const Object& objectB) const;
 
+		// Create the delete lists of both objects, in parallel if the current context
+		// has several threads. The lists are in ascending order.
+		static void                 CreateDeleteLists(const Object& objectA, Ouint deleteMaskA, const Object& objectB, Ouint deleteMaskB, std::vector<Oint>& deleteListA, std::vector<Oint>& deleteListB);
+
 		// Delete polygons and vertices based on the specified delete mask (bitwise
 		// combinations of RELPOS_STATUS).
 		static void                 DeletePolygons(Object& objectA, Ouint deleteMaskA, Object& objectB, Ouint deleteMaskB);
@@ -103,17 +294,148 @@ namespace enterprise_manager {
 		void                        DeleteUnusedVertices();
 
 		// Mark un-marked vertices according to their status relative to objectB
-		// (INSIDE or OUTSIDE).
-		void                        MarkVertices(Object& objectB);
+		// (INSIDE or OUTSIDE). The hierarchy of objectB must be built.
+		void                        MarkVertices(const Object& objectB);
+
+		// Build the mesh and the extent hierarchy of the polygons used for ray casting.
+		// They must be cleared before polygons are added, removed or deleted.
+		void                        BuildHierarchy();
+		void                        ClearHierarchy();
+
+		// Collect the indexes of the polygons which may be hit by the ray at a
+		// distance of at least minDistance, in ascending order. Without a hierarchy
+		// all polygons are returned.
+		void                        FindRayCandidates(const Vec3<T>& origin, const Vec3<T>& dir, T minDistance, std::vector<Oint>& candidates) const;
 
 		// Build adjacency info for all the vertices in the object.
 		void                        BuildVertexAdjacencyInfo();
 
+		// The state of a scratch object in which a worker thread of SplitBy subdivides
+		// polygons of another object ahead, see SubdivideAhead.
+		struct SplitScratch {
+			// The object being split. The scratch object looks up its vertices, but
+			// neither changes nor adds any.
+			const Object*           object;
+			// The polygon of object being subdivided, and whether it was removed.
+			const Polygon<T>*       polygon;
+			Obool                   removed;
+			// The first vertex the scratch object created for the polygon.
+			Ouint                   firstVertex;
+			// The points looked up and not found among the vertices of object.
+			std::vector<Vec3<T> >   points;
+			// The vertices of object marked as boundary.
+			std::vector<Vertex<T>*> boundary;
+			// The candidates of objectB of the polygons.
+			std::vector<Oint>       candidates;
+		};
+
+		// A polygon subdivided ahead in the scratch object of thread. Its vertices,
+		// sub polygons, points, boundary vertices and candidates are the ranges
+		// [first, last) of the lists of the scratch object. The pairs counted while
+		// finding the candidates are kept for the polygons subdivided again.
+		struct SplitAhead {
+			Obool                   done;
+			Ouint                   thread;
+			Obool                   removed;
+			Ouint                   subdivisions;
+			Ouint64                 overlappingPairs;
+			Ouint64                 separatedPairs;
+			Ouint                   firstCandidate;
+			Ouint                   lastCandidate;
+			Ouint                   firstVertex;
+			Ouint                   lastVertex;
+			Ouint                   firstPolygon;
+			Ouint                   lastPolygon;
+			Ouint                   firstPoint;
+			Ouint                   lastPoint;
+			Ouint                   firstBoundary;
+			Ouint                   lastBoundary;
+			typename Context<T>::Statistics statistics;
+		};
+
+		// A polygon of objectB cutting a polygon of this object, see CutPolygons.
+		struct PolygonCut {
+			// The plane of the polygon of objectB.
+			Vec3<T>                 normal;
+			T                       d;
+			// The ends of the segment the two polygons share.
+			Vec3<T>                 start;
+			Vec3<T>                 end;
+		};
+
+		// A corner of a fragment of a polygon being cut. vertex is the vertex of the
+		// polygon at the corner, if any. boundary is set for the corners lying on a cut.
+		struct FragmentPoint {
+			Vec3<T>                 point;
+			Vertex<T>*              vertex;
+			Obool                   boundary;
+		};
+
+		// Split this object by objectB as SplitBy above. If testB is specified, the
+		// polygons of this object existing before the call are only tested against the
+		// polygons of objectB whose flag is set in testB. If created is specified, it
+		// receives a flag per polygon afterwards, set for the polygons created by the
+		// call. complete is set if the call got through all polygons.
+		Ouint                       SplitBy(const Object& objectB, const std::vector<Obool>* testB, std::vector<Obool>* created, Obool* complete);
+
+		// Collect the polygons of the hierarchy whose extents overlap the extent in
+		// ascending order. index maps the polygons of the hierarchy to those of the
+		// object if the hierarchy was built over a part of them.
+		static void                 QueryCandidates(const BoundingVolumeHierarchy<T>& hierarchy, const std::vector<Oint>* index, const Extent<T>& extent, std::vector<Oint>& candidates);
+
+		// Find the first polygon of objectB from candidates[first] on which intersects
+		// polygonA. Returns its position in candidates and fills the segments for the
+		// subdivision, or returns the number of candidates if there is none.
+		static Ouint                FindIntersectingPolygon(const Polygon<T>& polygonA, const Object& objectB, const std::vector<Oint>& candidates, Ouint first, Segment<T>& segmentA, Segment<T>& segmentB);
+
+		// Subdivide the polygons [first, last) of this object by objectB ahead on the
+		// threads of pool, each thread in its own scratch object. With testIndexB the
+		// polygons before existing take their candidates from testHierarchyB, built
+		// over the polygons testIndexB of objectB. This object is not changed,
+		// CommitAhead takes over the sub polygons in the order of _polygon.
+		void                        SubdivideAhead(const Object& objectB, const BoundingVolumeHierarchy<T>& hierarchyB, const BoundingVolumeHierarchy<T>& testHierarchyB, const std::vector<Oint>* testIndexB, const PlaneTable<T>& planesB, Ouint existing, Ouint first, Ouint last, WorkerPool<T>& pool, const std::vector<Object*>& scratch, std::vector<SplitAhead>& ahead);
+
+		// Subdivide polygonA of the object this scratch object works for by the
+		// candidates of objectB, as SplitBy does, and fill in ahead.
+		void                        SubdividePolygonAhead(Polygon<T>& polygonA, const Object& objectB, const std::vector<Oint>& candidates, SplitAhead& ahead);
+
+		// Replace the polygon at index by its sub polygons from scratch and return
+		// true, unless a point looked up ahead lies at a vertex created since the
+		// polygons were subdivided ahead. Then the polygon would have been subdivided
+		// differently, it is left as it is and false is returned.
+		Obool                       CommitAhead(Ouint index, const SplitAhead& ahead, const Object& scratch);
+
+		// Split the polygons [0, count) of this object by objectB with
+		// Context::arrangementSplit. All the cuts of a polygon are collected first, in
+		// parallel, and the polygon is then replaced by the fragments of all the cuts at
+		// once instead of being subdivided by one polygon of objectB after another.
+		// The fragments of a concave polygon are not always simple polygons, concave
+		// polygons are left to SubdivideEach. Returns the number of cuts and subdivisions.
+		Ouint                       CutPolygons(const Object& objectB, const BoundingVolumeHierarchy<T>& hierarchyB, const BoundingVolumeHierarchy<T>& testHierarchyB, const std::vector<Oint>* testIndexB, const PlaneTable<T>& planesB, Ouint count);
+
+		// Subdivide the polygons of this object at indexes by one polygon of objectB
+		// after another, as SplitBy does without Context::arrangementSplit, and then
+		// the sub polygons appended by the subdivisions. The polygons at indexes only
+		// meet the polygons of objectB in testIndexB, if given. Returns the number of
+		// subdivisions.
+		Ouint                       SubdivideEach(const std::vector<Ouint>& indexes, const Object& objectB, const BoundingVolumeHierarchy<T>& hierarchyB, const BoundingVolumeHierarchy<T>& testHierarchyB, const std::vector<Oint>* testIndexB, const PlaneTable<T>& planesB);
+
+		// Replace the polygon at index by its fragments. A fragment is split along the
+		// line of a cut only where the segment of the cut crosses it, so the polygon is
+		// not split further than its cuts need.
+		void                        CutPolygon(Ouint index, const std::vector<PolygonCut>& cuts);
+
+		// Split the convex fragment by the plane of the cut into below and above if the
+		// segment of the cut crosses it and return true. Otherwise return false and only
+		// mark the corners of the fragment lying on the segment as boundary.
+		static Obool                SplitFragment(std::vector<FragmentPoint>& fragment, const PolygonCut& cut, T tolerance, std::vector<FragmentPoint>& below, std::vector<FragmentPoint>& above);
+
 		// Subdivide polygonA so that it does not intersect B.
 		// segmentA and segmentB are results of the intersection routine.
 		void                        Subdivide(Polygon<T>& polygonA, const Polygon<T>& polygonB, Segment<T>& segmentA, Segment<T>& segmentB);
 
-		// Find the position of polygonA relative to the object (INSIDE, OUTSIDE, SAME or OPPOSITE)
+		// Find the position of polygonA relative to the object (INSIDE, OUTSIDE, SAME or OPPOSITE).
+		// The mesh of the object must be built.
 		RELPOS_STATUS               FindRelativePosition(const Polygon<T>& polygonA) const;
 
 		// Create a vertex on an edge of the polygon and add it to the object if it does not exist.
@@ -130,8 +452,9 @@ namespace enterprise_manager {
 		// Must clean up afterwards by calling CleanPolygons
 		void                        RemovePolygon(Polygon<T>* polygon);
 
-		// Clean up the polygon list removing NULL entries
-		void                        CleanPolygonList();
+		// Clean up the polygon list removing NULL entries. The flags, one per polygon,
+		// are moved along with the polygons.
+		void                        CleanPolygonList(std::vector<Obool>* flags = NULL);
 
 		// Check if a vertex exists at the specified point. If it does not exists it
 		// is created, added to the object and returned. Otherwise the existing
@@ -140,12 +463,25 @@ namespace enterprise_manager {
 
 		Vertex<T>*                  GetExistingVertex(const Vec3<T>& point);
 
+		// Mark the vertex as boundary. A scratch object only records the vertices of
+		// the object it works for, they are marked by CommitAhead.
+		void                        MarkBoundary(Vertex<T>* vertex);
+
 		T							MaxDistance();
 
 	private:
 		std::vector<Vertex<T>*>     _vertex;
 		std::vector<Polygon<T>*>    _polygon;
 		Extent<T>                   _extent;
+		// Spatial hash of _vertex used by GetExistingVertex.
+		VertexGrid<T>               _vertexGrid;
+		// Extent hierarchy and mesh of _polygon, only valid between BuildHierarchy and ClearHierarchy.
+		BoundingVolumeHierarchy<T>  _hierarchy;
+		Mesh<T>                     _mesh;
+		Allocator<T>*               _allocator;
+		Obool                       _ownsAllocator;
+		// Only set in the scratch objects of SplitBy.
+		SplitScratch*               _scratch;
 
 		std::map<std::pair<Oint, Oint>, Oint>
 			GetEdgeMap();
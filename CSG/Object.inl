@@ -15,11 +15,13 @@ namespace enterprise_manager {
 	template <class T>
 	/*static*/ void
 		Object<T>::SetTolerance(Object& objectA, Object& objectB) {
+			Context<T>& context = Context<T>::current();
+			PhaseTimer<T> timer(context, Context<T>::Statistics::SET_TOLERANCE);
 			T d = max(objectA.MaxDistance(), objectB.MaxDistance());
 			Ofloat alfa = 1.e9;
 
-			Vertex<T>::tolerance = d * alfa * Vertex<T>::epsilonValue;
-			Vertex<T>::unitTolerance = alfa * Vertex<T>::epsilonValue;
+			context.tolerance = d * alfa * context.epsilonValue;
+			context.unitTolerance = alfa * context.epsilonValue;
 		}
 
 	template <class T>
@@ -41,22 +43,79 @@ namespace enterprise_manager {
 		}
 
 	template <class T>
-	Object<T>::Object() {
+	Object<T>::Object()
+		: _allocator(new PoolAllocator<T>),
+		_ownsAllocator(true),
+		_scratch(NULL) {
+		this->failed = false;
+	}
+
+	template <class T>
+	Object<T>::Object(Allocator<T>* allocator)
+		: _allocator(allocator ? allocator : new PoolAllocator<T>),
+		_ownsAllocator(allocator == NULL),
+		_scratch(NULL) {
 		this->failed = false;
 	}
 
 	template <class T>
 	/* virtual */
 	Object<T>::~Object() {
-		while (!_vertex.empty()) {
-			delete _vertex.back();
-			_vertex.pop_back();
+		Clear();
+		delete _scratch;
+		// An own pool releases all its blocks at once
+		if (_ownsAllocator)
+			delete _allocator;
+	}
+
+	template <class T>
+	inline const Allocator<T>&
+		Object<T>::allocator() const {
+			return *_allocator;
+		}
+
+	template <class T>
+	Vertex<T>*
+		Object<T>::NewVertex(const Vec3<T>& point) {
+			return new (_allocator->Allocate(sizeof(Vertex<T>))) Vertex<T>(point);
 		}
-		while (!_polygon.empty()) {
-			delete _polygon.back();
-			_polygon.pop_back();
+
+	template <class T>
+	Polygon<T>*
+		Object<T>::NewPolygon(const std::vector<Vertex<T>*>& vertices, Oint index) {
+			return new (_allocator->Allocate(sizeof(Polygon<T>))) Polygon<T>(vertices, index);
+		}
+
+	template <class T>
+	Polygon<T>*
+		Object<T>::NewPolygon(const Polygon<T>& original, const std::vector<Vertex<T>*>& vertices) {
+			return new (_allocator->Allocate(sizeof(Polygon<T>))) Polygon<T>(original, vertices);
+		}
+
+	template <class T>
+	Polygon<T>*
+		Object<T>::NewPolygon(const std::vector<Vertex<T>*>& vertices, Oint index, const Polygon<T>& original) {
+			return new (_allocator->Allocate(sizeof(Polygon<T>))) Polygon<T>(vertices, index, original);
+		}
+
+	template <class T>
+	void
+		Object<T>::DeleteVertex(Vertex<T>* vertex) {
+			//like delete, accept the NULL entries the vertex and polygon lists may contain
+			if (!vertex)
+				return;
+			vertex->~Vertex<T>();
+			_allocator->Free(vertex, sizeof(Vertex<T>));
+		}
+
+	template <class T>
+	void
+		Object<T>::DeletePolygon(Polygon<T>* polygon) {
+			if (!polygon)
+				return;
+			polygon->~Polygon<T>();
+			_allocator->Free(polygon, sizeof(Polygon<T>));
 		}
-	}
 
 	template <class T>
 	void
@@ -84,7 +143,7 @@ namespace enterprise_manager {
 
 			std::vector<std::pair<Oint, Oint>> invalid_edges;
 			std::map<std::pair<Oint, Oint>, Oint>::const_iterator it;
-			T local_tolerance = Vertex<T>::tolerance;// * 2;
+			T local_tolerance = Context<T>::current().tolerance;// * 2;
 			for (it = edgeMap.begin(); it != edgeMap.end(); ++it) {
 				if (it->second % 2 != 0) {
 					Obool same = false;
@@ -186,152 +245,919 @@ namespace enterprise_manager {
 	template <class T>
 	/* static */  void
 		Object<T>::CreateUnion(Object& objectA, Object& objectB) {
-			T savedTolerance = Vertex<Odouble>::tolerance;
-			T savedUnitTolerance = Vertex<Odouble>::unitTolerance;
+			Context<T> context;
+			CreateUnion(objectA, objectB, context);
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::CreateUnion(Object& objectA, Object& objectB, Context<T>& context) {
+			OperationScope<T> scope(context);
+			// Only copy the objects if the operation may be aborted by its budget
+			Object* copyA = context.limited() ? objectA.Clone() : NULL;
+			Object* copyB = context.limited() ? objectB.Clone() : NULL;
+			RunUnion(objectA, objectB);
+			EndOperation(objectA, copyA);
+			if (copyB != NULL)
+				EndOperation(objectB, copyB);
+		}
 
+	template <class T>
+	/* static */  void
+		Object<T>::RunUnion(Object& objectA, Object& objectB) {
+			O_TRACE_SCOPE("CreateUnion");
+			Context<T>& context = Context<T>::current();
 			SetTolerance(objectA, objectB);
-			SubdivideObjects(objectA, objectB);
+			PLACEMENT_TYPE placement = SubdivideOrPlace(objectA, objectB);
+			if (context.aborted())
+				return;
+			switch (placement) {
+			case APART:
+				objectA.Append(objectB);
+				objectA.CalculateExtents();
+				return;
+			case B_INSIDE_A:
+				return;
+			case A_INSIDE_B:
+				objectA.Clear();
+				objectA.Append(objectB);
+				objectA._extent = objectB._extent;
+				return;
+			default:
+				break;
+			}
 			DeletePolygons(objectA, (INSIDE | OPPOSITE), objectB, (INSIDE | SAME | OPPOSITE));
-			objectA.DeleteUnusedVertices();
-			objectA.Merge(objectB);
+			if (context.aborted())
+				return;
+			{
+				PhaseTimer<T> timer(context, Context<T>::Statistics::DELETE_POLYGONS);
+				objectA.DeleteUnusedVertices();
+			}
+			{
+				PhaseTimer<T> timer(context, Context<T>::Statistics::MERGE);
+				objectA.Merge(objectB);
+			}
 
 			//CLEAN UP OBJECT
+			O_TRACE_SCOPE("CleanUp");
+			PhaseTimer<T> timer(context, Context<T>::Statistics::CLEAN_UP);
 			for (Ouint i = 0; i < objectA._vertex.size(); ++i) {
 				objectA._vertex[i]->setStatus(UNKNOWN);
 				objectA._vertex[i]->ClearAdjacencyInfo();
 			}
 			for (Ouint i = 0; i < objectA._polygon.size(); ++i) {
-				objectA._polygon[i]->CalculatePlaneEquation();
-				objectA._polygon[i]->CalculateExtents();
+				objectA._polygon[i]->CalculatePlaneEquationAndExtents();
 			}
 			objectA.Simplify();
 			objectA.CalculateExtents();
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::CreateUnion(Object& objectA, const std::vector<Object*>& objectsB) {
+			Context<T> context;
+			CreateUnion(objectA, objectsB, context);
+		}
 
-			//restore tolerance 
-			Vertex<Odouble>::tolerance = savedTolerance;
-			Vertex<Odouble>::unitTolerance = savedUnitTolerance;
+	template <class T>
+	/* static */  void
+		Object<T>::CreateUnion(Object& objectA, const std::vector<Object*>& objectsB, Context<T>& context) {
+			OperationScope<T> scope(context);
+			Object* objectB = Union(objectsB, context);
+			if (!context.aborted() && !objectB->_polygon.empty())
+				CreateUnion(objectA, *objectB, context);
+			delete objectB;
 		}
 
 	template <class T>
 	/* static */  void
 		Object<T>::CreateIntersection(Object& objectA, Object& objectB) {
-			T savedTolerance = Vertex<Odouble>::tolerance;
-			T savedUnitTolerance = Vertex<Odouble>::unitTolerance;
+			Context<T> context;
+			CreateIntersection(objectA, objectB, context);
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::CreateIntersection(Object& objectA, Object& objectB, Context<T>& context) {
+			OperationScope<T> scope(context);
+			// Only copy the objects if the operation may be aborted by its budget
+			Object* copyA = context.limited() ? objectA.Clone() : NULL;
+			Object* copyB = context.limited() ? objectB.Clone() : NULL;
+			RunIntersection(objectA, objectB);
+			EndOperation(objectA, copyA);
+			if (copyB != NULL)
+				EndOperation(objectB, copyB);
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::RunIntersection(Object& objectA, Object& objectB) {
+			O_TRACE_SCOPE("CreateIntersection");
+			Context<T>& context = Context<T>::current();
 			SetTolerance(objectA, objectB);
-			SubdivideObjects(objectA, objectB);
+			PLACEMENT_TYPE placement = SubdivideOrPlace(objectA, objectB);
+			if (context.aborted())
+				return;
+			switch (placement) {
+			case APART:
+				objectA.Clear();
+				objectA.CalculateExtents();
+				return;
+			case A_INSIDE_B:
+				return;
+			case B_INSIDE_A:
+				objectA.Clear();
+				objectA.Append(objectB);
+				objectA._extent = objectB._extent;
+				return;
+			default:
+				break;
+			}
 			DeletePolygons(objectA, (OUTSIDE | OPPOSITE), objectB, (OUTSIDE | SAME | OPPOSITE));
-			objectA.DeleteUnusedVertices();
-
-			objectA.Merge(objectB);
+			if (context.aborted())
+				return;
+			{
+				PhaseTimer<T> timer(context, Context<T>::Statistics::DELETE_POLYGONS);
+				objectA.DeleteUnusedVertices();
+			}
+			{
+				PhaseTimer<T> timer(context, Context<T>::Statistics::MERGE);
+				objectA.Merge(objectB);
+			}
 
 			//CLEAN UP OBJECT
+			O_TRACE_SCOPE("CleanUp");
+			PhaseTimer<T> timer(context, Context<T>::Statistics::CLEAN_UP);
 			for (Ouint i = 0; i < objectA._vertex.size(); ++i) {
 				objectA._vertex[i]->setStatus(UNKNOWN);
 				objectA._vertex[i]->ClearAdjacencyInfo();
 			}
 			for (Ouint i = 0; i < objectA._polygon.size(); ++i) {
-				objectA._polygon[i]->CalculatePlaneEquation();
-				objectA._polygon[i]->CalculateExtents();
+				objectA._polygon[i]->CalculatePlaneEquationAndExtents();
 			}
 			objectA.Simplify();
 			objectA.CalculateExtents();
-
-			Vertex<Odouble>::tolerance = savedTolerance;
-			Vertex<Odouble>::unitTolerance = savedUnitTolerance;
 		}
 
 	template <class T>
 	/* static */  void
 		Object<T>::CreateDifference(Object& objectA, Object& objectB) {
-			T savedTolerance = Vertex<Odouble>::tolerance;
-			T savedUnitTolerance = Vertex<Odouble>::unitTolerance;
+			Context<T> context;
+			CreateDifference(objectA, objectB, context);
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::CreateDifference(Object& objectA, Object& objectB, Context<T>& context) {
+			OperationScope<T> scope(context);
+			// Only copy the objects if the operation may be aborted by its budget
+			Object* copyA = context.limited() ? objectA.Clone() : NULL;
+			Object* copyB = context.limited() ? objectB.Clone() : NULL;
+			RunDifference(objectA, objectB);
+			EndOperation(objectA, copyA);
+			if (copyB != NULL)
+				EndOperation(objectB, copyB);
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::RunDifference(Object& objectA, Object& objectB) {
+			O_TRACE_SCOPE("CreateDifference");
+			Context<T>& context = Context<T>::current();
 			SetTolerance(objectA, objectB);
-			SubdivideObjects(objectA, objectB);
+			PLACEMENT_TYPE placement = SubdivideOrPlace(objectA, objectB);
+			if (context.aborted())
+				return;
+			switch (placement) {
+			case APART:
+				return;
+			case A_INSIDE_B:
+				objectA.Clear();
+				objectA.CalculateExtents();
+				return;
+			case B_INSIDE_A: {
+				// objectB becomes a cavity of objectA
+				Ouint first = (Ouint)objectA._polygon.size();
+				objectA.Append(objectB);
+				for (Ouint i = first; i < objectA._polygon.size(); ++i) {
+					objectA._polygon[i]->Reverse();
+					objectA._polygon[i]->CalculatePlaneEquation();
+				}
+				return;
+			}
+			default:
+				break;
+			}
 			DeletePolygons(objectA, (INSIDE | SAME), objectB, (OUTSIDE | SAME | OPPOSITE));
-			objectA.MergeReversed(objectB);
+			if (context.aborted())
+				return;
+			{
+				PhaseTimer<T> timer(context, Context<T>::Statistics::MERGE);
+				objectA.MergeReversed(objectB);
+			}
+			O_TRACE_SCOPE("CleanUp");
+			PhaseTimer<T> timer(context, Context<T>::Statistics::CLEAN_UP);
 			objectA.CalculateExtents();
-			Vertex<Odouble>::tolerance = savedTolerance;
-			Vertex<Odouble>::unitTolerance = savedUnitTolerance;
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::CreateDifference(Object& objectA, const std::vector<Object*>& objectsB) {
+			Context<T> context;
+			CreateDifference(objectA, objectsB, context);
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::CreateDifference(Object& objectA, const std::vector<Object*>& objectsB, Context<T>& context) {
+			O_TRACE_SCOPE("CreateDifference");
+			OperationScope<T> scope(context);
+			// Objects which do not touch each other are subtracted together, so objectA is
+			// split and classified once per group instead of once per object. Overlapping
+			// objects go to different groups, (A - B1) - B2 is the same as A - (B1 U B2).
+			std::vector<std::vector<const Object*> > groups;
+			for (Ouint i = 0; i < objectsB.size(); ++i) {
+				const Object* objectB = objectsB[i];
+				if (objectB->_polygon.empty() || !Extent<T>::Overlap(objectA._extent, objectB->_extent))
+					continue;
+				Ouint g = 0;
+				for (; g < groups.size(); ++g) {
+					Obool disjoint = true;
+					for (Ouint j = 0; j < groups[g].size() && disjoint; ++j)
+						disjoint = !Extent<T>::Overlap(groups[g][j]->_extent, objectB->_extent);
+					if (disjoint)
+						break;
+				}
+				if (g == groups.size())
+					groups.push_back(std::vector<const Object*>());
+				groups[g].push_back(objectB);
+			}
+
+			Object* copyA = (context.limited() && !groups.empty()) ? objectA.Clone() : NULL;
+			for (Ouint g = 0; g < groups.size() && !context.aborted(); ++g) {
+				// The cutter has a shell per object. FindPlacement only takes the result
+				// from the operands if all of them lie on the same side of objectA, e.g.
+				// all inside as cavities, otherwise the polygons are classified.
+				Object cutter;
+				for (Ouint j = 0; j < groups[g].size(); ++j)
+					cutter.Append(*groups[g][j]);
+				cutter.CalculateExtents();
+				// The sub polygons of a subdivision reach over the whole polygon, so a large
+				// polygon of objectA would be split by every object of the group again and
+				// again. Cut objectA between the objects first, then each object only meets
+				// the polygons around it.
+				// The parts the cut leaves whole are merged again afterwards.
+				PlaneSplits splits;
+				if (groups[g].size() > 1) {
+					SetTolerance(objectA, cutter);
+					std::vector<std::pair<Oint, T> > planes;
+					FindSeparatingPlanes(groups[g], 0, (Ouint)groups[g].size(), planes);
+					objectA.SplitByPlanes(planes, splits);
+				}
+				RunDifference(objectA, cutter);
+				if (!context.aborted())
+					objectA.MergePlaneSplits(splits);
+			}
+			EndOperation(objectA, copyA);
+		}
+
+	template <class T>
+	/* static */ void
+		Object<T>::EndOperation(Object& object, Object* copy) {
+			if (Context<T>::current().aborted()) {
+				object.Clear();
+				if (copy != NULL) {
+					object.Append(*copy);
+					object._extent = copy->_extent;
+				}
+				else {
+					object.failed = true;
+					object.CalculateExtents();
+				}
+			}
+			delete copy;
+		}
+
+	template <class T>
+	Obool
+		Object<T>::ExceedsBudget(const Object& objectB) {
+			Context<T>& context = Context<T>::current();
+			Ouint maxPolygons = (context.budget.polygons > 0) ? context.budget.polygons : MAX_POLYGONS;
+			if (_polygon.size() > maxPolygons) {
+				context.Abort(Context<T>::POLYGON_LIMIT);
+			}
+			else if (context.budget.bytes > 0) {
+				Ouint64 bytes = _allocator->bytes();
+				if (objectB._allocator != _allocator)
+					bytes += objectB._allocator->bytes();
+				if (bytes > context.budget.bytes)
+					context.Abort(Context<T>::MEMORY_LIMIT);
+			}
+			return context.aborted();
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::UnionTree(std::vector<Object*>& objects, Ouint first, Ouint last) {
+			if (last - first == 1)
+				return objects[first];
+
+			// Halve the objects at the median of their centres along the axis the centres
+			// spread most, so objects near each other end up in the same branch.
+			Vec3<T> min = (objects[first]->_extent.min() + objects[first]->_extent.max()) / T(2);
+			Vec3<T> max = min;
+			for (Ouint k = first + 1; k < last; ++k) {
+				Vec3<T> centre = (objects[k]->_extent.min() + objects[k]->_extent.max()) / T(2);
+				for (Oint axis = X; axis <= Z; ++axis) {
+					min[axis] = O_MIN(min[axis], centre[axis]);
+					max[axis] = O_MAX(max[axis], centre[axis]);
+				}
+			}
+			Oint axis = X;
+			if (max[Y] - min[Y] > max[axis] - min[axis])
+				axis = Y;
+			if (max[Z] - min[Z] > max[axis] - min[axis])
+				axis = Z;
+			Ouint middle = first + (last - first) / 2;
+			std::nth_element(objects.begin() + first, objects.begin() + middle, objects.begin() + last,
+				[axis](const Object* a, const Object* b) { return a->_extent.min()[axis] + a->_extent.max()[axis] < b->_extent.min()[axis] + b->_extent.max()[axis]; });
+
+			// Each branch gets its own context with its share of the threads, the second
+			// branch runs on a new thread if there is more than one.
+			Context<T>& context = Context<T>::current();
+			Ouint threadCount = O_MAX(context.threadCount, 1u);
+			Context<T> contextA, contextB;
+			contextA.CopySettings(context);
+			contextB.CopySettings(context);
+			contextA.threadCount = threadCount - threadCount / 2;
+			contextB.threadCount = O_MAX(threadCount / 2, 1u);
+			Object* objectA = NULL;
+			Object* objectB = NULL;
+			auto branchB = [&]() {
+				ContextScope<T> scope(contextB);
+				objectB = UnionTree(objects, middle, last);
+			};
+			std::thread thread;
+			if (threadCount > 1)
+				thread = std::thread(branchB);
+			{
+				ContextScope<T> scope(contextA);
+				objectA = UnionTree(objects, first, middle);
+			}
+			if (threadCount > 1)
+				thread.join();
+			else
+				branchB();
+			context.statistics.Add(contextA.statistics);
+			context.statistics.Add(contextB.statistics);
+			context.Abort(contextA.abortReason);
+			context.Abort(contextB.abortReason);
+
+			// The objects are clones, Union throws them away if the operation is aborted.
+			// A branch whose objects were apart has several shells, see FindPlacement.
+			if (!context.aborted())
+				RunUnion(*objectA, *objectB);
+			delete objectB;
+			return objectA;
+		}
+
+	template <class T>
+	/* static */ void
+		Object<T>::FindSeparatingPlanes(std::vector<const Object*>& objects, Ouint first, Ouint last, std::vector<std::pair<Oint, T> >& planes) {
+			if (last - first < 2)
+				return;
+
+			// Look for the gap between the extents which divides the objects most evenly
+			T tolerance = Context<T>::current().tolerance;
+			Oint bestAxis = -1;
+			Ouint bestBalance = last - first;
+			T bestValue = 0;
+			for (Oint axis = X; axis <= Z; ++axis) {
+				std::sort(objects.begin() + first, objects.begin() + last,
+					[axis](const Object* a, const Object* b) { return a->_extent.min()[axis] < b->_extent.min()[axis]; });
+				T prefixMax = objects[first]->_extent.max()[axis];
+				for (Ouint k = first + 1; k < last; ++k) {
+					T nextMin = objects[k]->_extent.min()[axis];
+					if (Greater(nextMin, prefixMax, 2 * tolerance)) {
+						Ouint below = k - first;
+						Ouint above = last - k;
+						Ouint balance = (below > above) ? below - above : above - below;
+						if (balance < bestBalance) {
+							bestAxis = axis;
+							bestBalance = balance;
+							bestValue = (prefixMax + nextMin) / 2;
+						}
+					}
+					prefixMax = O_MAX(prefixMax, objects[k]->_extent.max()[axis]);
+				}
+			}
+			if (bestAxis == -1)
+				return;
+
+			planes.push_back(std::make_pair(bestAxis, bestValue));
+			Ouint middle = (Ouint)(std::partition(objects.begin() + first, objects.begin() + last,
+				[bestAxis, bestValue](const Object* object) { return object->_extent.max()[bestAxis] < bestValue; }) - objects.begin());
+			FindSeparatingPlanes(objects, first, middle, planes);
+			FindSeparatingPlanes(objects, middle, last, planes);
 		}
 
 	template <class T>
 	void
-		Object<T>::GetFaceSetIndexes(std::vector<Oint>& coordIndex) const {
-			coordIndex.clear();
-			std::map<Vertex<T>*, Ouint> vertexMap;
+		Object<T>::SplitByPlanes(const std::vector<std::pair<Oint, T> >& planes, PlaneSplits& splits) {
+			std::vector<Oint> origin;
+			for (Ouint j = 0; j < planes.size(); ++j)
+				SplitByPlane(planes[j].first, planes[j].second, origin, splits.original);
+			splits.part.clear();
+			splits.partOrigin.clear();
+			for (Ouint i = 0; i < origin.size(); ++i) {
+				if (origin[i] == -1)
+					continue;
+				splits.part.push_back(_polygon[i]->vertex());
+				splits.partOrigin.push_back(origin[i]);
+			}
+		}
 
-			for (Ouint i = 0; i < _vertex.size(); ++i) {
-				if (_vertex[i])
-					vertexMap[_vertex[i]] = i;
+	template <class T>
+	void
+		Object<T>::SplitByPlane(Oint axis, T value, std::vector<Oint>& origin, std::vector<std::vector<Vertex<T>*> >& original) {
+			typedef std::pair<Oint, Oint> Edge;
+			T tolerance = Context<T>::current().tolerance;
+			Ouint count = (Ouint)_polygon.size();
+			origin.resize(count, -1);
+			// The polygons do not always share the vertices at their corners, the edges
+			// are told by the first vertex at each end
+			_vertexGrid.Update(_vertex, tolerance);
+			// A polygon can be split if it is convex and has three vertices on each side,
+			// counting the vertices to be created on the edges crossing the plane
+			std::vector<Obool> split(count, false);
+			std::vector<std::pair<Ouint, Edge> > crossingEdge;
+			for (Ouint i = 0; i < count; ++i) {
+				Polygon<T>* polygon = _polygon[i];
+				if (!Greater(value, polygon->extent().min()[axis], tolerance) || !Greater(polygon->extent().max()[axis], value, tolerance))
+					continue;
+				Ouint belowCount = 0;
+				Ouint aboveCount = 0;
+				const std::vector<Vertex<T>*>& vertex = polygon->vertex();
+				for (Ouint j = 0; j < vertex.size(); ++j) {
+					Vertex<T>* current = vertex[j];
+					Vertex<T>* next = vertex[polygon->NextIndex(j)];
+					T distance = current->point()[axis] - value;
+					T nextDistance = next->point()[axis] - value;
+					if (fabs(distance) <= tolerance) {
+						++belowCount;
+						++aboveCount;
+						continue;
+					}
+					++(distance < 0 ? belowCount : aboveCount);
+					if ((distance < 0 && nextDistance > tolerance) || (distance > 0 && nextDistance < -tolerance)) {
+						++belowCount;
+						++aboveCount;
+						Oint a = _vertexGrid.Find(_vertex, current->point());
+						Oint b = _vertexGrid.Find(_vertex, next->point());
+						crossingEdge.push_back(std::make_pair(i, Edge(O_MIN(a, b), O_MAX(a, b))));
+					}
+				}
+				split[i] = belowCount >= 3 && aboveCount >= 3 && polygon->IsConvex();
 			}
-			for (Ouint i = 0; i < _polygon.size(); ++i) {
+			// The vertex created on a crossing edge would be in the middle of the edge
+			// of a polygon left whole, so the polygons sharing the edge are left whole too
+			std::map<Edge, Obool> splitEdge;
+			for (Ouint k = 0; k < crossingEdge.size(); ++k)
+				splitEdge[crossingEdge[k].second] = true;
+			Obool changed = true;
+			while (changed) {
+				changed = false;
+				for (Ouint k = 0; k < crossingEdge.size(); ++k) {
+					Obool& edgeSplit = splitEdge[crossingEdge[k].second];
+					if (edgeSplit && !split[crossingEdge[k].first]) {
+						edgeSplit = false;
+						changed = true;
+					}
+				}
+				for (Ouint k = 0; k < crossingEdge.size(); ++k) {
+					if (split[crossingEdge[k].first] && !splitEdge[crossingEdge[k].second]) {
+						split[crossingEdge[k].first] = false;
+						changed = true;
+					}
+				}
+			}
+
+			std::vector<Vertex<T>*> below, above;
+			for (Ouint i = 0; i < count; ++i) {
+				if (!split[i])
+					continue;
 				Polygon<T>* polygon = _polygon[i];
-				if (polygon) {
-					for (Ouint j = 0; j < polygon->vertex().size(); ++j) {
-						coordIndex.push_back(vertexMap[polygon->vertex()[j]]);
+				below.clear();
+				above.clear();
+				const std::vector<Vertex<T>*>& vertex = polygon->vertex();
+				for (Ouint j = 0; j < vertex.size(); ++j) {
+					Vertex<T>* current = vertex[j];
+					Vertex<T>* next = vertex[polygon->NextIndex(j)];
+					T distance = current->point()[axis] - value;
+					T nextDistance = next->point()[axis] - value;
+					if (fabs(distance) <= tolerance) {
+						below.push_back(current);
+						above.push_back(current);
+						continue;
 					}
-					coordIndex.push_back(-1);
+					(distance < 0 ? below : above).push_back(current);
+					if ((distance < 0 && nextDistance > tolerance) || (distance > 0 && nextDistance < -tolerance)) {
+						// Calculate from the lower end, so the polygon on the other side of the
+						// edge gets the same point
+						const Vec3<T>& a = (distance < 0) ? current->point() : next->point();
+						const Vec3<T>& b = (distance < 0) ? next->point() : current->point();
+						Vec3<T> point = a + (b - a) * ((value - a[axis]) / (b[axis] - a[axis]));
+						point[axis] = value;
+						Vertex<T>* edgeVertex = GetCreateVertex(point);
+						below.push_back(edgeVertex);
+						above.push_back(edgeVertex);
+					}
+				}
+
+				if (origin[i] == -1) {
+					origin[i] = (Oint)original.size();
+					original.push_back(vertex);
 				}
+				Polygon<T>* belowPolygon = NewPolygon(below, i);
+				Polygon<T>* abovePolygon = NewPolygon(above, (Oint)_polygon.size());
+				DeletePolygon(polygon);
+				_polygon[i] = belowPolygon;
+				_polygon.push_back(abovePolygon);
+				origin.push_back(origin[i]);
+			}
+		}
+
+	template <class T>
+	void
+		Object<T>::MergePlaneSplits(const PlaneSplits& splits) {
+			if (splits.original.empty())
+				return;
+			// Find the parts of each polygon split, a polygon is only merged if all its
+			// parts are still there
+			std::map<std::vector<Vertex<T>*>, Ouint> polygonIndex;
+			for (Ouint i = 0; i < _polygon.size(); ++i)
+				polygonIndex[_polygon[i]->vertex()] = i;
+			std::vector<std::vector<Ouint> > parts(splits.original.size());
+			std::vector<Obool> whole(splits.original.size(), true);
+			for (Ouint k = 0; k < splits.part.size(); ++k) {
+				typename std::map<std::vector<Vertex<T>*>, Ouint>::const_iterator it = polygonIndex.find(splits.part[k]);
+				if (it == polygonIndex.end())
+					whole[splits.partOrigin[k]] = false;
+				else
+					parts[splits.partOrigin[k]].push_back(it->second);
 			}
+			std::vector<Obool> merged(_polygon.size(), false);
+			for (Ouint o = 0; o < parts.size(); ++o) {
+				for (Ouint k = 0; whole[o] && k < parts[o].size(); ++k)
+					merged[parts[o][k]] = true;
+			}
+			// The vertices created on the planes stay where polygons not merged use them,
+			// or other vertices at the same points
+			_vertexGrid.Update(_vertex, Context<T>::current().tolerance);
+			std::set<Oint> used;
+			for (Ouint i = 0; i < _polygon.size(); ++i) {
+				for (Ouint j = 0; !merged[i] && j < _polygon[i]->vertex().size(); ++j)
+					used.insert(_vertexGrid.Find(_vertex, _polygon[i]->vertex()[j]->point()));
+			}
+
+			std::set<std::pair<Vertex<T>*, Vertex<T>*> > edges;
+			std::map<Vertex<T>*, Vertex<T>*> next;
+			std::vector<Vertex<T>*> vertices;
+			for (Ouint o = 0; o < parts.size(); ++o) {
+				if (!whole[o])
+					continue;
+				// The edges between the parts run both ways, the others are the boundary
+				// of the polygon
+				edges.clear();
+				next.clear();
+				for (Ouint k = 0; k < parts[o].size(); ++k) {
+					const Polygon<T>& part = *_polygon[parts[o][k]];
+					for (Ouint j = 0; j < part.vertex().size(); ++j)
+						edges.insert(std::make_pair(part.vertex()[j], part.vertex()[part.NextIndex(j)]));
+				}
+				for (typename std::set<std::pair<Vertex<T>*, Vertex<T>*> >::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+					if (edges.find(std::make_pair(it->second, it->first)) == edges.end())
+						next[it->first] = it->second;
+				}
+				const std::vector<Vertex<T>*>& originalVertex = splits.original[o];
+				vertices.clear();
+				Vertex<T>* vertex = originalVertex[0];
+				Ouint boundary = 0;
+				do {
+					typename std::map<Vertex<T>*, Vertex<T>*>::const_iterator it = next.find(vertex);
+					if (it == next.end())
+						break;
+					if (used.count(_vertexGrid.Find(_vertex, vertex->point())) != 0 || std::find(originalVertex.begin(), originalVertex.end(), vertex) != originalVertex.end())
+						vertices.push_back(vertex);
+					vertex = it->second;
+					++boundary;
+				} while (vertex != originalVertex[0] && boundary < next.size());
+				// Leave the parts if their boundary is not a single loop
+				if (vertex != originalVertex[0] || boundary != next.size())
+					continue;
+
+				Ouint first = parts[o][0];
+				DeletePolygon(_polygon[first]);
+				_polygon[first] = NewPolygon(vertices, first);
+				for (Ouint k = 1; k < parts[o].size(); ++k) {
+					DeletePolygon(_polygon[parts[o][k]]);
+					_polygon[parts[o][k]] = NULL;
+				}
+			}
+			CleanPolygonList();
+			DeleteUnusedVertices();
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Union(const Object& objectA, const Object& objectB) {
+			Context<T> context;
+			return Union(objectA, objectB, context);
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Union(const Object& objectA, const Object& objectB, Context<T>& context) {
+			Object* result = objectA.Clone();
+			Object* cloneB = objectB.Clone();
+			OperationScope<T> scope(context);
+			RunUnion(*result, *cloneB);
+			delete cloneB;
+			EndOperation(*result, NULL);
+			return result;
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Union(const std::vector<Object*>& objects) {
+			Context<T> context;
+			return Union(objects, context);
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Union(const std::vector<Object*>& objects, Context<T>& context) {
+			OperationScope<T> scope(context);
+			std::vector<Object*> clones;
+			clones.reserve(objects.size());
+			for (Ouint i = 0; i < objects.size(); ++i) {
+				if (!objects[i]->_polygon.empty())
+					clones.push_back(objects[i]->Clone());
+			}
+			if (clones.empty())
+				return new Object<T>();
+			Object* result = UnionTree(clones, 0, (Ouint)clones.size());
+			EndOperation(*result, NULL);
+			return result;
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Intersection(const Object& objectA, const Object& objectB) {
+			Context<T> context;
+			return Intersection(objectA, objectB, context);
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Intersection(const Object& objectA, const Object& objectB, Context<T>& context) {
+			Object* result = objectA.Clone();
+			Object* cloneB = objectB.Clone();
+			OperationScope<T> scope(context);
+			RunIntersection(*result, *cloneB);
+			delete cloneB;
+			EndOperation(*result, NULL);
+			return result;
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Difference(const Object& objectA, const Object& objectB) {
+			Context<T> context;
+			return Difference(objectA, objectB, context);
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Difference(const Object& objectA, const Object& objectB, Context<T>& context) {
+			Object* result = objectA.Clone();
+			Object* cloneB = objectB.Clone();
+			OperationScope<T> scope(context);
+			RunDifference(*result, *cloneB);
+			delete cloneB;
+			EndOperation(*result, NULL);
+			return result;
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Difference(const Object& objectA, const std::vector<Object*>& objectsB) {
+			Context<T> context;
+			return Difference(objectA, objectsB, context);
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::Difference(const Object& objectA, const std::vector<Object*>& objectsB, Context<T>& context) {
+			Object* result = objectA.Clone();
+			OperationScope<T> scope(context);
+			CreateDifference(*result, objectsB, context);
+			EndOperation(*result, NULL);
+			return result;
+		}
+
+	template <class T>
+	void
+		Object<T>::GetFaceSetIndexes(std::vector<Oint>& coordIndex) const {
+			Mesh<T> mesh;
+			GetMesh(mesh);
+			mesh.GetFaceSetIndexes(coordIndex);
 		}
 
 	template <class T>
 	void
 		Object<T>::GetCoords(std::vector<Vec3<CSGReal> >& coord) const {
 			coord.clear();
+			coord.reserve(_vertex.size());
 			for (Ouint i = 0; i < _vertex.size(); ++i) {
 				coord.push_back(_vertex[i]->point());
 			}
 		}
 
+	template <class T>
+	void
+		Object<T>::GetMesh(Mesh<T>& mesh) const {
+			mesh.Build(_vertex, _polygon);
+		}
+
 	template <class T>
 	void
 		Object<T>::Transform(const Matrix4<T>& matrix) {
+			_vertexGrid.Clear();
+			if (_vertex.empty()) {
+				CalculateExtents();
+				return;
+			}
+
+			// Gather the points into one array so the matrix is applied to all of them
+			// in a single batch, and take the extent of the object when scattering back.
+			std::vector<T> coords(3 * _vertex.size());
+			for (Ouint i = 0; i < _vertex.size(); ++i) {
+				const Vec3<T>& point = _vertex[i]->_point;
+				coords[3 * i + X] = point[X];
+				coords[3 * i + Y] = point[Y];
+				coords[3 * i + Z] = point[Z];
+			}
+			matrix.TransformPoints(coords.data(), _vertex.size());
+			Vec3<T> max(coords[X], coords[Y], coords[Z]);
+			Vec3<T> min(coords[X], coords[Y], coords[Z]);
 			for (Ouint i = 0; i < _vertex.size(); ++i) {
-				Vec3<T> point(_vertex[i]->_point[0], _vertex[i]->_point[1], _vertex[i]->_point[2]);
-				point *= matrix;
-				_vertex[i]->_point = Vec3<T>(point[0], point[1], point[2]);
+				Vec3<T>& point = _vertex[i]->_point;
+				point = Vec3<T>(coords[3 * i + X], coords[3 * i + Y], coords[3 * i + Z]);
+				max.MaxComp(point);
+				min.MinComp(point);
 			}
+			_extent.setMin(min);
+			_extent.setMax(max);
+
 			for (Ouint i = 0; i < _polygon.size(); ++i) {
-				_polygon[i]->CalculatePlaneEquation();
-				_polygon[i]->CalculateExtents();
+				_polygon[i]->CalculatePlaneEquationAndExtents();
+			}
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::CreateFromIndexedFaceSet(const std::vector<Vec3<T> >& coord, const std::vector<Oint>& coordIndex, Obool /* ccw */, Obool /* convex */, Allocator<T>* allocator) {
+			Object<T>* object = new Object<T>(allocator);
+
+			if (coord.empty())
+				return object;
+
+			// Populate the vertex array and calculate extent.
+			Vec3<T> max(coord[0][0], coord[0][1], coord[0][2]);
+			Vec3<T> min(coord[0][0], coord[0][1], coord[0][2]);
+			for (Ouint i = 0; i < coord.size(); ++i) {
+				Vec3<T> v = Vec3<T>(coord[i][0], coord[i][1], coord[i][2]);
+				object->_vertex.push_back(object->NewVertex(v));
+				max.MaxComp(v);
+				min.MinComp(v);
+			}
+			object->_extent.setMin(min);
+			object->_extent.setMax(max);
+
+			// Populate the polygon array and join adjacent vertices.
+			std::vector<Vertex<T>*> polygonVertices;
+			for (Ouint i = 0; i < coordIndex.size(); ++i) {
+				if (coordIndex[i] != -1) {
+					polygonVertices.push_back(object->_vertex[coordIndex[i]]);
+				}
+				else {
+					object->_polygon.push_back(object->NewPolygon(polygonVertices, object->_polygon.size()));
+					polygonVertices.clear();
+				}
+			}
+
+			return object;
+		}
+
+	template <class T>
+	/* static */ Object<T>*
+		Object<T>::CreateFromIndexedPolygons(const T* coords, Ouint coordCount, const Ouint* offsets, const Ouint* indexes, Ouint polygonCount, Allocator<T>* allocator) {
+			Object<T>* object = new Object<T>(allocator);
+
+			if (coordCount == 0)
+				return object;
+
+			// Populate the vertex array and calculate extent.
+			object->_vertex.reserve(coordCount);
+			Vec3<T> max(coords[X], coords[Y], coords[Z]);
+			Vec3<T> min(coords[X], coords[Y], coords[Z]);
+			for (Ouint i = 0; i < coordCount; ++i, coords += 3) {
+				Vec3<T> v(coords[X], coords[Y], coords[Z]);
+				object->_vertex.push_back(object->NewVertex(v));
+				max.MaxComp(v);
+				min.MinComp(v);
+			}
+			object->_extent.setMin(min);
+			object->_extent.setMax(max);
+
+			// Populate the polygon array, the vertices are shared through the indexes.
+			object->_polygon.reserve(polygonCount);
+			std::vector<Vertex<T>*> polygonVertices;
+			for (Ouint i = 0; i < polygonCount; ++i) {
+				if (offsets[i] == offsets[i + 1])
+					continue;
+				polygonVertices.clear();
+				for (Ouint k = offsets[i]; k < offsets[i + 1]; ++k) {
+					polygonVertices.push_back(object->_vertex[indexes[k]]);
+				}
+				object->_polygon.push_back(object->NewPolygon(polygonVertices, object->_polygon.size()));
+			}
+
+			return object;
+		}
+
+	template <class T>
+	Object<T>*
+		Object<T>::Clone(Allocator<T>* allocator) const {
+			Object<T>* object = new Object<T>(allocator);
+			object->failed = failed;
+			object->Append(*this);
+			object->_extent = _extent;
+			return object;
+		}
+
+	template <class T>
+	void
+		Object<T>::Clear() {
+			while (!_vertex.empty()) {
+				DeleteVertex(_vertex.back());
+				_vertex.pop_back();
+			}
+			while (!_polygon.empty()) {
+				DeletePolygon(_polygon.back());
+				_polygon.pop_back();
 			}
-			CalculateExtents();
+			_vertexGrid.Clear();
 		}
 
 	template <class T>
-	/* static */ Object<T>*
-		Object<T>::CreateFromIndexedFaceSet(const std::vector<Vec3<T> >& coord, const std::vector<Oint>& coordIndex, Obool /* ccw */, Obool /* convex */) {
-			Object<T>* object = new Object<T>;
-
-			if (coord.empty())
-				return object;
-
-			// Populate the vertex array and calculate extent.
-			Vec3<T> max(coord[0][0], coord[0][1], coord[0][2]);
-			Vec3<T> min(coord[0][0], coord[0][1], coord[0][2]);
-			for (Ouint i = 0; i < coord.size(); ++i) {
-				Vec3<T> v = Vec3<T>(coord[i][0], coord[i][1], coord[i][2]);
-				object->_vertex.push_back(new Vertex<T>(v));
-				max.MaxComp(v);
-				min.MinComp(v);
+	void
+		Object<T>::Append(const Object& objectB) {
+			std::unordered_map<const Vertex<T>*, Vertex<T>*> vertexMap;
+			vertexMap.reserve(objectB._vertex.size());
+			_vertex.reserve(_vertex.size() + objectB._vertex.size());
+			for (Ouint i = 0; i < objectB._vertex.size(); ++i) {
+				const Vertex<T>* vertexB = objectB._vertex[i];
+				if (!vertexB)
+					continue;
+				Vertex<T>* vertex = NewVertex(vertexB->point());
+				vertex->setStatus(vertexB->status());
+				_vertex.push_back(vertex);
+				vertexMap[vertexB] = vertex;
 			}
-			object->_extent.setMin(min);
-			object->_extent.setMax(max);
 
-			// Populate the polygon array and join adjacent vertices.
+			_polygon.reserve(_polygon.size() + objectB._polygon.size());
 			std::vector<Vertex<T>*> polygonVertices;
-			for (Ouint i = 0; i < coordIndex.size(); ++i) {
-				if (coordIndex[i] != -1) {
-					polygonVertices.push_back(object->_vertex[coordIndex[i]]);
-				}
-				else {
-					object->_polygon.push_back(new Polygon<T>(polygonVertices, object->_polygon.size()));
-					polygonVertices.clear();
+			for (Ouint i = 0; i < objectB._polygon.size(); ++i) {
+				const Polygon<T>* polygonB = objectB._polygon[i];
+				if (!polygonB)
+					continue;
+				polygonVertices.clear();
+				for (Ouint j = 0; j < polygonB->vertex().size(); ++j) {
+					Vertex<T>*& vertex = vertexMap[polygonB->vertex()[j]];
+					// A vertex missing in the vertex list of objectB is added to the list
+					if (!vertex) {
+						vertex = NewVertex(polygonB->vertex()[j]->point());
+						vertex->setStatus(polygonB->vertex()[j]->status());
+						_vertex.push_back(vertex);
+					}
+					polygonVertices.push_back(vertex);
 				}
+				Polygon<T>* polygon = NewPolygon(*polygonB, polygonVertices);
+				polygon->setIndex((Oint)_polygon.size());
+				_polygon.push_back(polygon);
 			}
-
-			return object;
 		}
 
 	template <class T>
@@ -344,14 +1170,14 @@ namespace enterprise_manager {
 			Vec3<T> min(vertices[0]->point());
 			for (Ouint i = 0; i < vertices.size(); ++i) {
 				Vec3<T> v = vertices[i]->point();
-				object->_vertex.push_back(new Vertex<T>(v));
+				object->_vertex.push_back(object->NewVertex(v));
 				max.MaxComp(v);
 				min.MinComp(v);
 			}
 			object->_extent.setMin(min);
 			object->_extent.setMax(max);
 
-			object->_polygon.push_back(new Polygon<T>(vertices, object->_polygon.size()));
+			object->_polygon.push_back(object->NewPolygon(vertices, object->_polygon.size()));
 
 			return object;
 		}
@@ -359,6 +1185,7 @@ namespace enterprise_manager {
 	template <class T>
 	void
 		Object<T>::Merge(const Object<T>& objectB) {
+			O_TRACE_SCOPE("Merge");
 			for (Ouint i = 0; i < objectB.polygon().size(); ++i) {
 				Polygon<T>* polygonB = objectB.polygon()[i];
 				std::vector<Vertex<T>*> polygonVertices;
@@ -367,13 +1194,14 @@ namespace enterprise_manager {
 					// Get or create vertex corresponding to the new point.
 					polygonVertices.push_back(GetCreateVertex(pointB));
 				}
-				_polygon.push_back(new Polygon<T>(polygonVertices, _polygon.size()));
+				_polygon.push_back(NewPolygon(polygonVertices, _polygon.size()));
 			}
 		}
 
 	template <class T>
 	void
 		Object<T>::MergeReversed(const Object& objectB) {
+			O_TRACE_SCOPE("Merge");
 			for (Ouint i = 0; i < objectB.polygon().size(); ++i) {
 				Polygon<T>* polygonB = objectB.polygon()[i];
 				std::vector<Vertex<T>*> polygonVertices;
@@ -382,33 +1210,40 @@ namespace enterprise_manager {
 					// Get or create vertex corresponding to the new point.
 					polygonVertices.push_back(GetCreateVertex(pointB));
 				}
-				_polygon.push_back(new Polygon<T>(polygonVertices, _polygon.size()));
+				_polygon.push_back(NewPolygon(polygonVertices, _polygon.size()));
+			}
+		}
+
+	template <class T>
+	RELPOS_STATUS
+		Object<T>::ClassifyPolygon(const Polygon<T>& polygonA, const Object& objectB) const {
+			// For each vertexA in polygonA
+			for (Ouint j = 0; j < polygonA.vertex().size(); ++j) {
+				Vertex<T>* vertexA = polygonA.vertex()[j];
+				// If the status of vertexA is not BOUNDARY
+				// the status of the polygonA is the status of vertexA.
+				if (vertexA->status() == INSIDE || vertexA->status() == OUTSIDE) {
+					return vertexA->status();
+				}
 			}
+			// If no status for polygonA, was found
+			// determine status of polygonA using the polygon classification routine
+			return objectB.FindRelativePosition(polygonA);
 		}
 
 	template <class T>
 	std::vector<Oint>
 		Object<T>::CreateDeleteList(Ouint deleteMask, const Object& objectB) const {
+			Context<T>& context = Context<T>::current();
 			std::vector<Oint> deleteList;
 			// For each polygonA in objectA 
 			for (Ouint i = 0; i < _polygon.size(); ++i) {
-				Polygon<T>* polygonA = _polygon[i];
-				// For each vertexA in polygonA
-				RELPOS_STATUS polyStatus = UNKNOWN;
-				for (Ouint j = 0; j < polygonA->vertex().size(); ++j) {
-					Vertex<T>* vertexA = polygonA->vertex()[j];
-					// If the status of vertexA is not BOUNDARY
-					// the status of the polygonA is the status of vertexA.
-					if (vertexA->status() == INSIDE || vertexA->status() == OUTSIDE) {
-						polyStatus = vertexA->status();
+				if ((i & 63) == 0) {
+					if (context.Check())
 						break;
-					}
-				}
-				// If no status for polygonA, was found
-				// determine status of polygonA using the polygon classification routine
-				if (polyStatus == UNKNOWN) {
-					polyStatus = objectB.FindRelativePosition(*polygonA);
+					context.ReportProgress(Odouble(i) / _polygon.size());
 				}
+				RELPOS_STATUS polyStatus = ClassifyPolygon(*_polygon[i], objectB);
 
 				// If polygons of this status should be deleted for this operation
 				// delete polygonA from objectA
@@ -422,12 +1257,57 @@ namespace enterprise_manager {
 			return deleteList;
 		}
 
+	template <class T>
+	/* static */ void
+		Object<T>::CreateDeleteLists(const Object& objectA, Ouint deleteMaskA, const Object& objectB, Ouint deleteMaskB, std::vector<Oint>& deleteListA, std::vector<Oint>& deleteListB) {
+			if (Context<T>::current().threadCount <= 1) {
+				deleteListA = objectA.CreateDeleteList(deleteMaskA, objectB);
+				if (!Context<T>::current().aborted())
+					deleteListB = objectB.CreateDeleteList(deleteMaskB, objectA);
+				return;
+			}
+
+			// The areas are cached by the polygons on first use, compute them before
+			// the polygons are shared by the threads
+			for (Ouint i = 0; i < objectA._polygon.size(); ++i)
+				objectA._polygon[i]->Area();
+			for (Ouint i = 0; i < objectB._polygon.size(); ++i)
+				objectB._polygon[i]->Area();
+
+			// Classify the polygons of both objects in one parallel loop, the polygons of objectB follow those of objectA
+			Ouint countA = (Ouint)objectA._polygon.size();
+			std::vector<RELPOS_STATUS> status(countA + objectB._polygon.size());
+			ParallelFor<T>((Ouint)status.size(), 16, [&](Ouint first, Ouint last) {
+				Context<T>& workerContext = Context<T>::current();
+				for (Ouint i = first; i < last; ++i) {
+					if (workerContext.Check())
+						return;
+					if (i < countA)
+						status[i] = objectA.ClassifyPolygon(*objectA._polygon[i], objectB);
+					else
+						status[i] = objectB.ClassifyPolygon(*objectB._polygon[i - countA], objectA);
+				}
+			});
+
+			deleteListA.clear();
+			deleteListB.clear();
+			for (Ouint i = 0; i < status.size(); ++i) {
+				if (i < countA) {
+					if (status[i] & deleteMaskA)
+						deleteListA.push_back(i);
+				}
+				else if (status[i] & deleteMaskB) {
+					deleteListB.push_back(i - countA);
+				}
+			}
+		}
+
 	template <class T>
 	void
 		Object<T>::DeletePolygons(const std::vector<Oint> deleteList) {
 			//delete
 			for (Ouint i = 0; i < deleteList.size(); ++i) {
-				delete _polygon[deleteList[i]];
+				DeletePolygon(_polygon[deleteList[i]]);
 				_polygon[deleteList[i]] = NULL;
 			}
 
@@ -439,9 +1319,29 @@ namespace enterprise_manager {
 	template <class T>
 	void
 		Object<T>::DeletePolygons(Object& objectA, Ouint deleteMaskA, Object& objectB, Ouint deleteMaskB) {
-			std::vector<Oint> deleteListA = objectA.CreateDeleteList(deleteMaskA, objectB);
-			std::vector<Oint> deleteListB = objectB.CreateDeleteList(deleteMaskB, objectA);
+			// Mark the vertices first, so only polygons without INSIDE or OUTSIDE
+			// vertices have to be classified by casting a ray
+			Context<T>& context = Context<T>::current();
+			std::vector<Oint> deleteListA, deleteListB;
+			{
+				O_TRACE_SCOPE("Classify");
+				PhaseTimer<T> timer(context, Context<T>::Statistics::DELETE_LISTS);
+				objectA.BuildHierarchy();
+				objectB.BuildHierarchy();
+				objectA.MarkVertices(objectB);
+				objectB.MarkVertices(objectA);
+
+				if (!context.aborted())
+					CreateDeleteLists(objectA, deleteMaskA, objectB, deleteMaskB, deleteListA, deleteListB);
+				objectA.ClearHierarchy();
+				objectB.ClearHierarchy();
+			}
+			// The lists are incomplete, leave the objects to the caller
+			if (context.aborted())
+				return;
 
+			O_TRACE_SCOPE("DeletePolygons");
+			PhaseTimer<T> timer(context, Context<T>::Statistics::DELETE_POLYGONS);
 			objectA.DeletePolygons(deleteListA);
 			objectB.DeletePolygons(deleteListB);
 		}
@@ -466,7 +1366,7 @@ namespace enterprise_manager {
 
 			for (Ouint i = 0; i < _vertex.size(); ++i) {
 				if (vertexUsed[i] == false) {
-					delete _vertex[i];
+					DeleteVertex(_vertex[i]);
 					_vertex[i] = false;
 				}
 				else {
@@ -474,6 +1374,7 @@ namespace enterprise_manager {
 				}
 			}
 			_vertex = newVertexList;
+			_vertexGrid.Clear();
 		}
 
 
@@ -489,84 +1390,838 @@ namespace enterprise_manager {
 			}
 		}
 
+	template <class T>
+	void
+		Object<T>::MarkVertices(const Object& objectB) {
+			// Statuses left over from a previous operation are not valid for objectB
+			for (Ouint i = 0; i < _vertex.size(); ++i) {
+				if (_vertex[i]->status() == INSIDE || _vertex[i]->status() == OUTSIDE)
+					_vertex[i]->setStatus(UNKNOWN);
+			}
+
+			// Vertices on the surface of objectB which were not marked during the
+			// subdivision (e.g. vertices of coplanar polygons) must stop the propagation
+			std::vector<Oint>& candidates = Context<T>::current().overlapPolygons;
+			Extent<T> pointExtent;
+			for (Ouint i = 0; i < _vertex.size(); ++i) {
+				Vertex<T>* vertexA = _vertex[i];
+				if (vertexA->status() != UNKNOWN)
+					continue;
+				pointExtent.setMin(vertexA->point());
+				pointExtent.setMax(vertexA->point());
+				objectB._hierarchy.Query(pointExtent, candidates);
+				for (Ouint k = 0; k < candidates.size(); ++k) {
+					Oint b = candidates[k];
+					if (EQ(objectB._mesh.PlaneToPointDistance(b, vertexA->point()), T(0), Context<T>::current().tolerance) &&
+						objectB._mesh.FindRelativePosition(b, vertexA->point()) != OUTSIDE) {
+						vertexA->setStatus(BOUNDARY);
+						break;
+					}
+				}
+			}
+
+			// Classify one polygon of each connected region of unmarked vertices and
+			// propagate its status over the region. The propagation stops at BOUNDARY vertices.
+			Context<T>& context = Context<T>::current();
+			BuildVertexAdjacencyInfo();
+			for (Ouint i = 0; i < _polygon.size(); ++i) {
+				if ((i & 63) == 0 && context.Check())
+					break;
+				Polygon<T>* polygonA = _polygon[i];
+				if (!polygonA->HasUnmarkedVertices())
+					continue;
+				RELPOS_STATUS status = objectB.FindRelativePosition(*polygonA);
+				// SAME and OPPOSITE only hold for the polygon itself, it is classified again in CreateDeleteList
+				if (status != INSIDE && status != OUTSIDE)
+					continue;
+				for (Ouint j = 0; j < polygonA->vertex().size(); ++j) {
+					if (polygonA->vertex()[j]->status() == UNKNOWN)
+						polygonA->vertex()[j]->MarkConnectedVertices(status);
+				}
+			}
+
+			// The adjacency info is not needed any more and would refer to deleted vertices
+			for (Ouint i = 0; i < _vertex.size(); ++i) {
+				_vertex[i]->ClearAdjacencyInfo();
+			}
+		}
+
+	template <class T>
+	void
+		Object<T>::BuildHierarchy() {
+			_mesh.Build(_vertex, _polygon);
+			_hierarchy.Build(_mesh.extentMin(), _mesh.extentMax());
+		}
+
+	template <class T>
+	void
+		Object<T>::ClearHierarchy() {
+			_hierarchy.Clear();
+			_mesh.Clear();
+		}
+
+	template <class T>
+	void
+		Object<T>::FindRayCandidates(const Vec3<T>& origin, const Vec3<T>& dir, T minDistance, std::vector<Oint>& candidates) const {
+			if (_hierarchy.empty()) {
+				candidates.resize(_polygon.size());
+				for (Ouint i = 0; i < _polygon.size(); ++i)
+					candidates[i] = i;
+				return;
+			}
+			//the hit tests of the callers accept points within the tolerance of a polygon
+			const Context<T>& context = Context<T>::current();
+			T margin = 4 * O_MAX(context.tolerance, context.epsilonValue);
+			_hierarchy.QueryRay(origin, dir, minDistance - margin, margin, candidates);
+		}
+
 	template <class T>
 	/* static */  void
 		Object<T>::SubdivideObjects(Object<T>& objectA, Object<T>& objectB) {
+			OperationScope<T> scope(Context<T>::current());
 			objectB.MakeCcw();
 			//1: Split the first object so that it doesn't intersect the second object
-			objectA.SplitBy(objectB);
+			Obool complete = false;
+			{
+				PhaseTimer<T> timer(Context<T>::current(), Context<T>::Statistics::SPLIT_FIRST);
+				objectA.SplitBy(objectB, NULL, NULL, &complete);
+			}
+			if (Context<T>::current().aborted())
+				return;
+			FinishSubdivision(objectA, objectB, complete);
+		}
+
+	template <class T>
+	/* static */  void
+		Object<T>::FinishSubdivision(Object<T>& objectA, Object<T>& objectB, Obool firstPassComplete) {
+			Context<T>& context = Context<T>::current();
 			//2: Split the second object so that it doesn't intersect the first object
-			objectB.SplitBy(objectA);
+			std::vector<Obool> createdB;
+			PhaseTimer<T> secondTimer(context, Context<T>::Statistics::SPLIT_SECOND);
+			objectB.SplitBy(objectA, NULL, &createdB, NULL);
+			secondTimer.Stop();
+			if (context.aborted())
+				return;
 			//3: Split the first object again, resolving newly introduced intersections
-			objectA.SplitBy(objectB);
+			PhaseTimer<T> thirdTimer(context, Context<T>::Statistics::SPLIT_THIRD);
+			objectA.SplitBy(objectB, firstPassComplete ? &createdB : NULL, NULL, NULL);
+			thirdTimer.Stop();
+			if (context.aborted())
+				return;
 
 			objectA.MakeCcw();
 		}
 
 	template <class T>
-	void
+	/* static */ typename Object<T>::PLACEMENT_TYPE
+		Object<T>::SubdivideOrPlace(Object<T>& objectA, Object<T>& objectB) {
+			if (objectA._polygon.empty() || objectB._polygon.empty())
+				return CROSSING;
+			if (!Extent<T>::Overlap(objectA._extent, objectB._extent))
+				return APART;
+
+			objectB.MakeCcw();
+			//1: Split the first object so that it doesn't intersect the second object
+			Obool complete = false;
+			PhaseTimer<T> timer(Context<T>::current(), Context<T>::Statistics::SPLIT_FIRST);
+			Ouint subdivisions = objectA.SplitBy(objectB, NULL, NULL, &complete);
+			timer.Stop();
+			if (Context<T>::current().aborted())
+				return CROSSING;
+			if (subdivisions == 0) {
+				objectA.MakeCcw();
+				PLACEMENT_TYPE placement = FindPlacement(objectA, objectB);
+				if (placement != CROSSING)
+					return placement;
+				// MakeCcw may have reversed the polygons tested by the first pass
+				complete = false;
+			}
+			FinishSubdivision(objectA, objectB, complete);
+			return CROSSING;
+		}
+
+	template <class T>
+	/* static */ typename Object<T>::PLACEMENT_TYPE
+		Object<T>::FindPlacement(Object<T>& objectA, Object<T>& objectB) {
+			O_TRACE_SCOPE("FindPlacement");
+			PhaseTimer<T> timer(Context<T>::current(), Context<T>::Statistics::PLACEMENT);
+			objectA.BuildHierarchy();
+			objectB.BuildHierarchy();
+			// Without intersections and contact every shell of an object is either inside
+			// or outside the other object. Objects with shells on both sides, e.g. the
+			// partial results of a union, are left to the classification.
+			PLACEMENT_TYPE placement = CROSSING;
+			if (!objectA.HasVertexOnSurface(objectB) && !objectB.HasVertexOnSurface(objectA)) {
+				RELPOS_STATUS statusA = objectA.FindShellPosition(objectB);
+				RELPOS_STATUS statusB = (statusA != UNKNOWN) ? objectB.FindShellPosition(objectA) : UNKNOWN;
+				if (statusA == OUTSIDE && statusB == OUTSIDE)
+					placement = APART;
+				else if (statusA == INSIDE && statusB == OUTSIDE)
+					placement = A_INSIDE_B;
+				else if (statusA == OUTSIDE && statusB == INSIDE)
+					placement = B_INSIDE_A;
+			}
+			objectA.ClearHierarchy();
+			objectB.ClearHierarchy();
+			return placement;
+		}
+
+	template <class T>
+	RELPOS_STATUS
+		Object<T>::FindShellPosition(const Object& objectB) const {
+			const std::vector<Vec3<T> >& coord = _mesh.coords();
+			const std::vector<Ouint>& offset = _mesh.offsets();
+			const std::vector<Ouint>& index = _mesh.indexes();
+			std::vector<Ouint> shell(coord.size());
+			for (Ouint i = 0; i < shell.size(); ++i)
+				shell[i] = i;
+			auto root = [&shell](Ouint i) -> Ouint {
+				while (shell[i] != i) {
+					shell[i] = shell[shell[i]];
+					i = shell[i];
+				}
+				return i;
+			};
+
+			// Vertices at the same point are not always shared, e.g. by objects read
+			// facet by facet, join them before the polygons
+			std::vector<Ouint> order(shell);
+			std::sort(order.begin(), order.end(), [&coord](Ouint a, Ouint b) {
+				if (coord[a][X] != coord[b][X])
+					return coord[a][X] < coord[b][X];
+				if (coord[a][Y] != coord[b][Y])
+					return coord[a][Y] < coord[b][Y];
+				return coord[a][Z] < coord[b][Z];
+			});
+			for (Ouint k = 1; k < order.size(); ++k) {
+				const Vec3<T>& a = coord[order[k - 1]];
+				const Vec3<T>& b = coord[order[k]];
+				if (a[X] == b[X] && a[Y] == b[Y] && a[Z] == b[Z])
+					shell[root(order[k])] = root(order[k - 1]);
+			}
+			for (Ouint p = 0; p < _mesh.polygonCount(); ++p) {
+				for (Ouint j = offset[p] + 1; j < offset[p + 1]; ++j)
+					shell[root(index[j])] = root(index[offset[p]]);
+			}
+
+			std::vector<Obool> classified(coord.size(), false);
+			RELPOS_STATUS position = UNKNOWN;
+			for (Ouint p = 0; p < _mesh.polygonCount(); ++p) {
+				if (_mesh.size(p) == 0)
+					continue;
+				Ouint first = root(index[offset[p]]);
+				if (classified[first])
+					continue;
+				classified[first] = true;
+				RELPOS_STATUS status = objectB.FindRelativePosition(*_polygon[p]);
+				if ((status != INSIDE && status != OUTSIDE) || (position != UNKNOWN && status != position))
+					return UNKNOWN;
+				position = status;
+			}
+			return position;
+		}
+
+	template <class T>
+	Obool
+		Object<T>::HasVertexOnSurface(const Object& objectB) const {
+			Context<T>& context = Context<T>::current();
+			std::vector<Oint>& candidates = context.overlapPolygons;
+			Extent<T> extent;
+			for (Ouint j = 0; j < objectB._vertex.size(); ++j) {
+				const Vec3<T>& point = objectB._vertex[j]->point();
+				extent.setMin(point);
+				extent.setMax(point);
+				if (!Extent<T>::Overlap(_extent, extent))
+					continue;
+				_hierarchy.Query(extent, candidates);
+				for (Ouint k = 0; k < candidates.size(); ++k) {
+					Oint i = candidates[k];
+					if (EQ(_mesh.PlaneToPointDistance(i, point), T(0), context.tolerance) && _mesh.FindRelativePosition(i, point) != OUTSIDE)
+						return true;
+				}
+			}
+			return false;
+		}
+
+	template <class T>
+	Ouint
 		Object<T>::SplitBy(const Object& objectB) {
+			OperationScope<T> scope(Context<T>::current());
+			return SplitBy(objectB, NULL, NULL, NULL);
+		}
+
+	template <class T>
+	Ouint
+		Object<T>::SplitBy(const Object& objectB, const std::vector<Obool>* testB, std::vector<Obool>* created, Obool* complete) {
+			O_TRACE_SCOPE("SplitBy");
 			int count = 0;
+			Ouint subdivisions = 0;
+			Ouint existing = (Ouint)_polygon.size();
+			Obool finished = true;
 			// Splitting ObjectA by ObjectB
 			// If extent of objectA overlaps extent of objeetB
 			if (Extent<T>::Overlap(_extent, objectB.extent())) {
-				// For each polygonA in objectA
-				// Do not process newly added Polygons at the end of the vector _polygon
-				for (Ouint i = 0; i < _polygon.size(); ++i) {
-					if (_polygon.size() > MAX_POLYGONS) {
-						printf("The amount of polygons (%d) extended the limit MAX_POLYGONS (%d)\n", _polygon.size(), MAX_POLYGONS);
-						//cout << "\nObjectA: MAX_POLYGONS limit reached.";
-						while (!_vertex.empty()) {
-							delete _vertex.back();
-							_vertex.pop_back();
+				// Build the extent hierarchy of objectB once, so each polygonA is only
+				// tested against the polygons of objectB whose extents it overlaps
+				BoundingVolumeHierarchy<T> hierarchyB;
+				hierarchyB.Build(objectB.polygon());
+				// Of the polygons whose extents overlap, those separated by a plane are
+				// left out before the intersection test
+				PlaneTable<T> planesB;
+				planesB.Build(objectB.polygon());
+				// The polygons existing before the call only meet the polygons of objectB
+				// flagged in testB, they have a smaller hierarchy of their own
+				BoundingVolumeHierarchy<T> testHierarchyB;
+				std::vector<Oint> testIndexB;
+				if (testB != NULL) {
+					std::vector<Vec3<T> > min, max;
+					for (Ouint j = 0; j < objectB.polygon().size(); ++j) {
+						if ((*testB)[j]) {
+							testIndexB.push_back(j);
+							min.push_back(objectB.polygon()[j]->extent().min());
+							max.push_back(objectB.polygon()[j]->extent().max());
 						}
-						while (!_polygon.empty()) {
-							delete _polygon.back();
-							_polygon.pop_back();
+					}
+					testHierarchyB.Build(min, max);
+				}
+				Context<T>& context = Context<T>::current();
+				if (context.arrangementSplit) {
+					subdivisions = CutPolygons(objectB, hierarchyB, testHierarchyB, (testB != NULL) ? &testIndexB : NULL, planesB, existing);
+				}
+				else {
+					std::vector<Oint>& candidates = context.overlapPolygons;
+					// With several threads the polygons of a generation are subdivided ahead,
+					// each in the scratch object of a worker, and taken over one after another
+					// in the order of _polygon, so the result is the same as with one thread.
+					Obool parallel = context.threadCount > 1;
+					WorkerPool<T> pool;
+					std::vector<Object*> scratch;
+					if (parallel) {
+						for (Ouint thread = 0; thread < pool.threadCount(); ++thread) {
+							scratch.push_back(new Object);
+							scratch.back()->_scratch = new SplitScratch;
+							scratch.back()->_scratch->object = this;
 						}
-						failed = true;
-						break;
 					}
-					Polygon<T>& polygonA = *_polygon[i];
-					// If the extent of polygonA overlaps the extent of objectB
-					if (Extent<T>::Overlap(polygonA.extent(), objectB.extent())) {
-						// For each polygonB in objectB
-						for (Ouint j = 0; j < objectB.polygon().size(); ++j) {
-							Polygon<T>& polygonB = *objectB.polygon()[j];
-							// If the extents of polygonA and polygonB overlap
-							if (Extent<T>::Overlap(polygonA.extent(), polygonB.extent())) {
-								// Analyze them as in "5. Do Two Polygons Intersect?"
-								Segment<T> segmentA, segmentB;
-								INTERSECT_TYPE intersection = Polygon<T>::Intersect(polygonA, polygonB, segmentA, segmentB);
-								// If they are not COPLANAR and do INTERSECT
-								if (intersection == INTERSECT) {
-									// Subdivide polygonA as in "6. Subdividing Non-Coplanar Polygons"
-									Subdivide(polygonA, polygonB, segmentA, segmentB);
-									if (_polygon[i] == NULL) {
-										if (i == _polygon.size() - 2)
-											count++;
-										else
-											count = 0;
-										//break;
-									}
-								}
-								else {
-									// Else if they do NOT-INTERSECT or if they are COPLANAR
-									//(do nothing)
+					std::vector<SplitAhead> ahead;
+					Ouint generationStart = 0;
+					Ouint generationEnd = 0;
+					// For each polygonA in objectA
+					// Newly added Polygons at the end of the vector _polygon are processed afterwards
+					for (Ouint i = 0; i < _polygon.size(); ++i) {
+						if (ExceedsBudget(objectB))
+							break;
+						if ((i & 63) == 0) {
+							if (context.Check())
+								break;
+							context.ReportProgress(Odouble(i) / _polygon.size());
+						}
+						// The polygons appended while subdividing a generation form the next one
+						if (parallel && i == generationEnd) {
+							generationStart = i;
+							generationEnd = _polygon.size();
+							SubdivideAhead(objectB, hierarchyB, testHierarchyB, (testB != NULL) ? &testIndexB : NULL, planesB, existing, generationStart, generationEnd, pool, scratch, ahead);
+							if (context.aborted())
+								break;
+						}
+						Polygon<T>& polygonA = *_polygon[i];
+						if (context.detailedStatistics)
+							++context.statistics.extentTests;
+						const SplitAhead* polygonAhead = parallel ? &ahead[i - generationStart] : NULL;
+						if (polygonAhead != NULL && CommitAhead(i, *polygonAhead, *scratch[polygonAhead->thread])) {
+							subdivisions += polygonAhead->subdivisions;
+							if (ExceedsBudget(objectB))
+								break;
+							if (_polygon[i] == NULL) {
+								if (i == _polygon.size() - 2)
+									count++;
+								else
+									count = 0;
+							}
+						}
+						// If the extent of polygonA overlaps the extent of objectB
+						else if (Extent<T>::Overlap(polygonA.extent(), objectB.extent())) {
+							// For each polygonB in objectB whose extent overlaps the extent of polygonA
+							// analyze them as in "5. Do Two Polygons Intersect?"
+							if (polygonAhead != NULL && polygonAhead->done) {
+								// A polygon subdivided ahead but not taken over keeps its candidates
+								const std::vector<Oint>& candidatesAhead = scratch[polygonAhead->thread]->_scratch->candidates;
+								candidates.assign(candidatesAhead.begin() + polygonAhead->firstCandidate, candidatesAhead.begin() + polygonAhead->lastCandidate);
+								context.statistics.overlappingPairs += polygonAhead->overlappingPairs;
+								context.statistics.separatedPairs += polygonAhead->separatedPairs;
+							}
+							else {
+								if (testB != NULL && i < existing)
+									QueryCandidates(testHierarchyB, &testIndexB, polygonA.extent(), candidates);
+								else
+									hierarchyB.Query(polygonA.extent(), candidates);
+								if (context.detailedStatistics)
+									context.statistics.overlappingPairs += candidates.size();
+								context.statistics.separatedPairs += planesB.RejectSeparated(polygonA, context.tolerance, candidates);
+							}
+							Segment<T> segmentA, segmentB;
+							Ouint k = FindIntersectingPolygon(polygonA, objectB, candidates, 0, segmentA, segmentB);
+							// If they are not COPLANAR and do INTERSECT
+							while (k < candidates.size()) {
+								++context.statistics.subdivisions;
+								++subdivisions;
+								// Subdivide polygonA as in "6. Subdividing Non-Coplanar Polygons"
+								Subdivide(polygonA, *objectB.polygon()[candidates[k]], segmentA, segmentB);
+								if (ExceedsBudget(objectB))
+									break;
+								if (_polygon[i] == NULL) {
+									if (i == _polygon.size() - 2)
+										count++;
+									else
+										count = 0;
+									// polygonA has been deleted, its sub polygons are appended to
+									// _polygon and will be split by the remaining polygons of objectB
+									break;
 								}
+								k = FindIntersectingPolygon(polygonA, objectB, candidates, k + 1, segmentA, segmentB);
 							}
 						}
+						if (context.aborted())
+							break;
+						// A polygon whose last sub polygon is split again and again.
+						if (count > 10) {
+							context.Abort(Context<T>::SUBDIVISION_LOOP);
+							finished = false;
+							break;
+						}
+					}
+					for (Ouint thread = 0; thread < scratch.size(); ++thread) {
+						delete scratch[thread];
+					}
+				}
+				// Without a budget, objects growing beyond MAX_POLYGONS are given up
+				if (context.abortReason == Context<T>::POLYGON_LIMIT && !context.limited()) {
+					Clear();
+					failed = true;
+				}
+			}
+			if (created != NULL) {
+				created->assign(_polygon.size(), false);
+				for (Ouint i = existing; i < _polygon.size(); ++i)
+					(*created)[i] = true;
+			}
+			// Clean up
+			CleanPolygonList(created);
+			if (complete != NULL)
+				*complete = finished;
+			return subdivisions;
+		}
+
+	template <class T>
+	/* static */ void
+		Object<T>::QueryCandidates(const BoundingVolumeHierarchy<T>& hierarchy, const std::vector<Oint>* index, const Extent<T>& extent, std::vector<Oint>& candidates) {
+			hierarchy.Query(extent, candidates);
+			if (index == NULL)
+				return;
+			//index is ascending, so the candidates stay in ascending order
+			for (Ouint k = 0; k < candidates.size(); ++k)
+				candidates[k] = (*index)[candidates[k]];
+		}
+
+	template <class T>
+	/* static */ Ouint
+		Object<T>::FindIntersectingPolygon(const Polygon<T>& polygonA, const Object& objectB, const std::vector<Oint>& candidates, Ouint first, Segment<T>& segmentA, Segment<T>& segmentB) {
+			Context<T>& context = Context<T>::current();
+			for (Ouint k = first; k < candidates.size(); ++k) {
+				const Polygon<T>& polygonB = *objectB.polygon()[candidates[k]];
+				Segment<T> candidateSegmentA, candidateSegmentB;
+				INTERSECT_TYPE intersection = Polygon<T>::Intersect(polygonA, polygonB, candidateSegmentA, candidateSegmentB);
+				++context.statistics.polygonPairs;
+				// Else if they do NOT-INTERSECT or if they are COPLANAR
+				//(do nothing)
+				if (intersection == INTERSECT) {
+					segmentA = candidateSegmentA;
+					segmentB = candidateSegmentB;
+					return k;
+				}
+			}
+			return (Ouint)candidates.size();
+		}
+
+	template <class T>
+	void
+		Object<T>::SubdivideAhead(const Object& objectB, const BoundingVolumeHierarchy<T>& hierarchyB, const BoundingVolumeHierarchy<T>& testHierarchyB, const std::vector<Oint>* testIndexB, const PlaneTable<T>& planesB, Ouint existing, Ouint first, Ouint last, WorkerPool<T>& pool, const std::vector<Object*>& scratch, std::vector<SplitAhead>& ahead) {
+			//the workers look up the vertices of this object in the grid, but must not update it
+			_vertexGrid.Update(_vertex, Context<T>::current().tolerance);
+			for (Ouint thread = 0; thread < scratch.size(); ++thread) {
+				scratch[thread]->Clear();
+				scratch[thread]->_scratch->points.clear();
+				scratch[thread]->_scratch->boundary.clear();
+				scratch[thread]->_scratch->candidates.clear();
+			}
+			ahead.resize(last - first);
+			pool.For(last - first, 4, [&](Ouint thread, Ouint rangeFirst, Ouint rangeLast) {
+				O_TRACE_SCOPE("SubdivideAhead");
+				Context<T>& context = Context<T>::current();
+				std::vector<Oint>& candidates = context.overlapPolygons;
+				for (Ouint j = rangeFirst; j < rangeLast; ++j) {
+					SplitAhead& polygonAhead = ahead[j];
+					polygonAhead.done = false;
+					if (context.Check())
+						return;
+					polygonAhead.thread = thread;
+					Polygon<T>& polygonA = *_polygon[first + j];
+					//the statistics of the polygon are only counted if it is committed
+					context.statistics = typename Context<T>::Statistics();
+					candidates.clear();
+					polygonAhead.overlappingPairs = 0;
+					polygonAhead.separatedPairs = 0;
+					if (Extent<T>::Overlap(polygonA.extent(), objectB.extent())) {
+						if (testIndexB != NULL && first + j < existing)
+							QueryCandidates(testHierarchyB, testIndexB, polygonA.extent(), candidates);
+						else
+							hierarchyB.Query(polygonA.extent(), candidates);
+						if (context.detailedStatistics)
+							polygonAhead.overlappingPairs = candidates.size();
+						polygonAhead.separatedPairs = planesB.RejectSeparated(polygonA, context.tolerance, candidates);
+						context.statistics.overlappingPairs += polygonAhead.overlappingPairs;
+						context.statistics.separatedPairs += polygonAhead.separatedPairs;
+					}
+					std::vector<Oint>& candidatesAhead = scratch[thread]->_scratch->candidates;
+					polygonAhead.firstCandidate = (Ouint)candidatesAhead.size();
+					candidatesAhead.insert(candidatesAhead.end(), candidates.begin(), candidates.end());
+					polygonAhead.lastCandidate = (Ouint)candidatesAhead.size();
+					scratch[thread]->SubdividePolygonAhead(polygonA, objectB, candidates, polygonAhead);
+					polygonAhead.statistics = context.statistics;
+					context.statistics = typename Context<T>::Statistics();
+				}
+			});
+		}
+
+	template <class T>
+	void
+		Object<T>::SubdividePolygonAhead(Polygon<T>& polygonA, const Object& objectB, const std::vector<Oint>& candidates, SplitAhead& ahead) {
+			Context<T>& context = Context<T>::current();
+			SplitScratch& scratch = *_scratch;
+			scratch.polygon = &polygonA;
+			scratch.removed = false;
+			scratch.firstVertex = (Ouint)_vertex.size();
+			ahead.subdivisions = 0;
+			ahead.firstVertex = (Ouint)_vertex.size();
+			ahead.firstPolygon = (Ouint)_polygon.size();
+			ahead.firstPoint = (Ouint)scratch.points.size();
+			ahead.firstBoundary = (Ouint)scratch.boundary.size();
+			Segment<T> segmentA, segmentB;
+			Ouint k = FindIntersectingPolygon(polygonA, objectB, candidates, 0, segmentA, segmentB);
+			while (k < candidates.size()) {
+				++context.statistics.subdivisions;
+				++ahead.subdivisions;
+				Subdivide(polygonA, *objectB.polygon()[candidates[k]], segmentA, segmentB);
+				if (scratch.removed)
+					break;
+				k = FindIntersectingPolygon(polygonA, objectB, candidates, k + 1, segmentA, segmentB);
+			}
+			ahead.removed = scratch.removed;
+			ahead.lastVertex = (Ouint)_vertex.size();
+			ahead.lastPolygon = (Ouint)_polygon.size();
+			ahead.lastPoint = (Ouint)scratch.points.size();
+			ahead.lastBoundary = (Ouint)scratch.boundary.size();
+			ahead.done = true;
+		}
+
+	template <class T>
+	Obool
+		Object<T>::CommitAhead(Ouint index, const SplitAhead& ahead, const Object& scratch) {
+			if (!ahead.done)
+				return false;
+			const SplitScratch& split = *scratch._scratch;
+			//the vertices existing before the generation were looked up ahead already
+			Context<T>& context = Context<T>::current();
+			_vertexGrid.Update(_vertex, context.tolerance);
+			for (Ouint j = ahead.firstPoint; j < ahead.lastPoint; ++j) {
+				if (_vertexGrid.Find(_vertex, split.points[j]) != -1)
+					return false;
+			}
+
+			Ouint firstVertex = (Ouint)_vertex.size();
+			for (Ouint j = ahead.firstVertex; j < ahead.lastVertex; ++j) {
+				Vertex<T>* vertex = NewVertex(scratch._vertex[j]->point());
+				vertex->setStatus(scratch._vertex[j]->status());
+				_vertex.push_back(vertex);
+			}
+			for (Ouint j = ahead.firstBoundary; j < ahead.lastBoundary; ++j) {
+				split.boundary[j]->setStatus(BOUNDARY);
+			}
+			std::vector<Vertex<T>*> vertices;
+			for (Ouint j = ahead.firstPolygon; j < ahead.lastPolygon; ++j) {
+				const Polygon<T>& subPolygon = *scratch._polygon[j];
+				//the vertices created ahead are replaced by their copies in this object
+				vertices = subPolygon.vertex();
+				for (Ouint v = 0; v < vertices.size(); ++v) {
+					for (Ouint created = ahead.firstVertex; created < ahead.lastVertex; ++created) {
+						if (vertices[v] == scratch._vertex[created]) {
+							vertices[v] = _vertex[firstVertex + created - ahead.firstVertex];
+							break;
+						}
+					}
+				}
+				Polygon<T>* polygon = NewPolygon(subPolygon, vertices);
+				polygon->setIndex(_polygon.size());
+				_polygon.push_back(polygon);
+			}
+			if (ahead.removed)
+				RemovePolygon(_polygon[index]);
+			context.statistics.Add(ahead.statistics);
+			return true;
+		}
+
+	template <class T>
+	Ouint
+		Object<T>::CutPolygons(const Object& objectB, const BoundingVolumeHierarchy<T>& hierarchyB, const BoundingVolumeHierarchy<T>& testHierarchyB, const std::vector<Oint>* testIndexB, const PlaneTable<T>& planesB, Ouint count) {
+			Context<T>& context = Context<T>::current();
+			std::vector<std::vector<PolygonCut> > cuts(count);
+			//the polygons are not changed while collecting, so they can be tested independently
+			ParallelFor<T>(count, 16, [&](Ouint first, Ouint last) {
+				O_TRACE_SCOPE("CollectCuts");
+				Context<T>& workerContext = Context<T>::current();
+				std::vector<Oint>& candidates = workerContext.overlapPolygons;
+				for (Ouint i = first; i < last; ++i) {
+					if (workerContext.Check())
+						return;
+					Polygon<T>& polygonA = *_polygon[i];
+					if (workerContext.detailedStatistics)
+						++workerContext.statistics.extentTests;
+					if (!Extent<T>::Overlap(polygonA.extent(), objectB.extent()))
+						continue;
+					if (testIndexB != NULL)
+						QueryCandidates(testHierarchyB, testIndexB, polygonA.extent(), candidates);
+					else
+						hierarchyB.Query(polygonA.extent(), candidates);
+					if (workerContext.detailedStatistics)
+						workerContext.statistics.overlappingPairs += candidates.size();
+					workerContext.statistics.separatedPairs += planesB.RejectSeparated(polygonA, workerContext.tolerance, candidates);
+					Segment<T> segmentA, segmentB;
+					Ouint k = FindIntersectingPolygon(polygonA, objectB, candidates, 0, segmentA, segmentB);
+					while (k < candidates.size()) {
+						const Polygon<T>& polygonB = *objectB.polygon()[candidates[k]];
+						Ray<T> intersectionLine;
+						Polygon<T>::CalcLineOfIntersection(polygonA, polygonB, intersectionLine);
+						segmentA.FindIntersection(segmentB, polygonA);
+						if (workerContext.detailedStatistics)
+							workerContext.statistics.CountIntersectionType(segmentA.IntersectionType());
+
+						PolygonCut cut;
+						cut.normal = polygonB.normal();
+						cut.d = polygonB.d();
+						//project the ends onto polygonA as CreateFaceVertex
+						cut.start = intersectionLine.point + intersectionLine.dir*segmentA.startDistance();
+						cut.start -= polygonA.normal()*(polygonA.normal()*cut.start + polygonA.d());
+						cut.end = intersectionLine.point + intersectionLine.dir*segmentA.endDistance();
+						cut.end -= polygonA.normal()*(polygonA.normal()*cut.end + polygonA.d());
+						cuts[i].push_back(cut);
+
+						k = FindIntersectingPolygon(polygonA, objectB, candidates, k + 1, segmentA, segmentB);
 					}
-					if (count > 10) {
-						cout << "\nObject<T>::SplitBy(): count > 10.";
+				}
+			});
+
+			Ouint subdivisions = 0;
+			std::vector<Ouint> concave;
+			for (Ouint i = 0; i < count && !context.aborted(); ++i) {
+				if ((i & 63) == 0 && !context.Check())
+					context.ReportProgress(Odouble(i) / count);
+				if (cuts[i].empty())
+					continue;
+				// The fragments of a concave polygon are not always simple polygons
+				if (!_polygon[i]->IsConvex()) {
+					concave.push_back(i);
+					continue;
+				}
+				subdivisions += (Ouint)cuts[i].size();
+				CutPolygon(i, cuts[i]);
+				ExceedsBudget(objectB);
+			}
+			if (!concave.empty() && !context.aborted())
+				subdivisions += SubdivideEach(concave, objectB, hierarchyB, testHierarchyB, testIndexB, planesB);
+			context.statistics.subdivisions += subdivisions;
+			return subdivisions;
+		}
+
+	template <class T>
+	Ouint
+		Object<T>::SubdivideEach(const std::vector<Ouint>& indexes, const Object& objectB, const BoundingVolumeHierarchy<T>& hierarchyB, const BoundingVolumeHierarchy<T>& testHierarchyB, const std::vector<Oint>* testIndexB, const PlaneTable<T>& planesB) {
+			Context<T>& context = Context<T>::current();
+			std::vector<Oint>& candidates = context.overlapPolygons;
+			Ouint subdivisions = 0;
+			// The sub polygons are appended to _polygon from appended on and split in turn
+			Ouint appended = (Ouint)_polygon.size();
+			for (Ouint n = 0; n < indexes.size() + (_polygon.size() - appended); ++n) {
+				if (ExceedsBudget(objectB) || context.Check())
+					break;
+				Ouint i = (n < indexes.size()) ? indexes[n] : appended + (n - (Ouint)indexes.size());
+				Polygon<T>& polygonA = *_polygon[i];
+				if (!Extent<T>::Overlap(polygonA.extent(), objectB.extent()))
+					continue;
+				if (testIndexB != NULL && n < indexes.size())
+					QueryCandidates(testHierarchyB, testIndexB, polygonA.extent(), candidates);
+				else
+					hierarchyB.Query(polygonA.extent(), candidates);
+				context.statistics.separatedPairs += planesB.RejectSeparated(polygonA, context.tolerance, candidates);
+				Segment<T> segmentA, segmentB;
+				Ouint k = FindIntersectingPolygon(polygonA, objectB, candidates, 0, segmentA, segmentB);
+				while (k < candidates.size()) {
+					++subdivisions;
+					Subdivide(polygonA, *objectB.polygon()[candidates[k]], segmentA, segmentB);
+					// polygonA has been deleted, its sub polygons are split later
+					if (_polygon[i] == NULL)
 						break;
+					k = FindIntersectingPolygon(polygonA, objectB, candidates, k + 1, segmentA, segmentB);
+				}
+			}
+			return subdivisions;
+		}
+
+	template <class T>
+	void
+		Object<T>::CutPolygon(Ouint index, const std::vector<PolygonCut>& cuts) {
+			T tolerance = Context<T>::current().tolerance;
+			Polygon<T>* polygon = _polygon[index];
+			const std::vector<Vertex<T>*>& vertex = polygon->vertex();
+
+			std::vector<std::vector<FragmentPoint> > fragments(1), next;
+			std::vector<FragmentPoint> below, above;
+			fragments[0].resize(vertex.size());
+			for (Ouint j = 0; j < vertex.size(); ++j) {
+				fragments[0][j].point = vertex[j]->point();
+				fragments[0][j].vertex = vertex[j];
+				fragments[0][j].boundary = false;
+			}
+			//the fragments are plain point lists until all the cuts are applied
+			for (Ouint c = 0; c < cuts.size(); ++c) {
+				next.clear();
+				for (Ouint f = 0; f < fragments.size(); ++f) {
+					next.resize(next.size() + 1);
+					if (SplitFragment(fragments[f], cuts[c], tolerance, below, above)) {
+						next.back().swap(below);
+						next.resize(next.size() + 1);
+						next.back().swap(above);
+					}
+					else {
+						next.back().swap(fragments[f]);
 					}
 				}
-				// Clean up
-				CleanPolygonList();
+				fragments.swap(next);
+			}
+
+			if (fragments.size() == 1) {
+				//the cuts only touch the polygon
+				for (Ouint j = 0; j < fragments[0].size(); ++j) {
+					if (fragments[0][j].boundary)
+						fragments[0][j].vertex->setStatus(BOUNDARY);
+				}
+				return;
+			}
+
+			std::vector<Vertex<T>*> vertices;
+			for (Ouint f = 0; f < fragments.size(); ++f) {
+				vertices.clear();
+				for (Ouint j = 0; j < fragments[f].size(); ++j) {
+					const FragmentPoint& point = fragments[f][j];
+					Vertex<T>* fragmentVertex = point.vertex ? point.vertex : GetCreateVertex(point.point);
+					if (point.boundary)
+						fragmentVertex->setStatus(BOUNDARY);
+					if (vertices.empty() || vertices.back() != fragmentVertex)
+						vertices.push_back(fragmentVertex);
+				}
+				if (vertices.size() > 1 && vertices.back() == vertices.front())
+					vertices.pop_back();
+				//the points of a sliver may have been merged
+				if (vertices.size() < 3)
+					continue;
+				_polygon.push_back(NewPolygon(vertices, (Oint)_polygon.size(), *polygon));
 			}
+			DeletePolygon(polygon);
+			_polygon[index] = NULL;
 		}
 
+	template <class T>
+	/* static */ Obool
+		Object<T>::SplitFragment(std::vector<FragmentPoint>& fragment, const PolygonCut& cut, T tolerance, std::vector<FragmentPoint>& below, std::vector<FragmentPoint>& above) {
+			std::vector<T>& distances = Context<T>::current().distancesA;
+			distances.resize(fragment.size());
+			Obool hasBelow = false;
+			Obool hasAbove = false;
+			for (Ouint j = 0; j < fragment.size(); ++j) {
+				distances[j] = cut.normal*fragment[j].point + cut.d;
+				hasBelow |= distances[j] < -tolerance;
+				hasAbove |= distances[j] > tolerance;
+			}
+
+			//position of a point on the plane along the segment, 0 at its start and 1 at its end
+			Vec3<T> direction = cut.end - cut.start;
+			T length = direction.Length();
+			T margin = (length > tolerance) ? tolerance / length : T(0);
+			auto onSegment = [&](const Vec3<T>& point) -> Obool {
+				if (length <= tolerance)
+					return point.Distance(cut.start) <= tolerance;
+				T position = ((point - cut.start)*direction) / (length*length);
+				return position >= -margin && position <= 1 + margin;
+			};
+
+			below.clear();
+			above.clear();
+			if (hasBelow && hasAbove && length > tolerance) {
+				T chordMin = std::numeric_limits<T>::max();
+				T chordMax = -std::numeric_limits<T>::max();
+				for (Ouint j = 0; j < fragment.size(); ++j) {
+					Ouint n = (j + 1 < fragment.size()) ? j + 1 : 0;
+					T distance = distances[j];
+					T nextDistance = distances[n];
+					if (fabs(distance) <= tolerance) {
+						below.push_back(fragment[j]);
+						above.push_back(fragment[j]);
+						T position = ((fragment[j].point - cut.start)*direction) / (length*length);
+						chordMin = O_MIN(chordMin, position);
+						chordMax = O_MAX(chordMax, position);
+						continue;
+					}
+					(distance < 0 ? below : above).push_back(fragment[j]);
+					if ((distance < 0 && nextDistance > tolerance) || (distance > 0 && nextDistance < -tolerance)) {
+						// Calculate from the smaller point, so the fragment on the other side
+						// of the edge gets the same point
+						Obool swap = fragment[n].point < fragment[j].point;
+						const Vec3<T>& a = swap ? fragment[n].point : fragment[j].point;
+						const Vec3<T>& b = swap ? fragment[j].point : fragment[n].point;
+						T distanceA = swap ? nextDistance : distance;
+						T distanceB = swap ? distance : nextDistance;
+						FragmentPoint edgePoint;
+						edgePoint.point = a + (b - a) * (distanceA / (distanceA - distanceB));
+						edgePoint.vertex = NULL;
+						edgePoint.boundary = false;
+						below.push_back(edgePoint);
+						above.push_back(edgePoint);
+						T position = ((edgePoint.point - cut.start)*direction) / (length*length);
+						chordMin = O_MIN(chordMin, position);
+						chordMax = O_MAX(chordMax, position);
+					}
+				}
+				// Split only if the segment runs through the fragment, not if it ends at its boundary
+				if (O_MIN(chordMax, T(1)) - O_MAX(chordMin, T(0)) > margin) {
+					for (Ouint j = 0; j < below.size(); ++j) {
+						if (fabs(cut.normal*below[j].point + cut.d) <= tolerance && onSegment(below[j].point))
+							below[j].boundary = true;
+					}
+					for (Ouint j = 0; j < above.size(); ++j) {
+						if (fabs(cut.normal*above[j].point + cut.d) <= tolerance && onSegment(above[j].point))
+							above[j].boundary = true;
+					}
+					return true;
+				}
+				below.clear();
+				above.clear();
+			}
+
+			for (Ouint j = 0; j < fragment.size(); ++j) {
+				if (fabs(distances[j]) <= tolerance && onSegment(fragment[j].point))
+					fragment[j].boundary = true;
+			}
+			return false;
+		}
 
 	template <class T>
 	void
@@ -577,6 +2232,9 @@ namespace enterprise_manager {
 			Polygon<T>::CalcLineOfIntersection(polygonA, polygonB, intersectionLine);
 
 			segmentA.FindIntersection(segmentB, polygonA);
+			Context<T>& context = Context<T>::current();
+			if (context.detailedStatistics)
+				context.statistics.CountIntersectionType(segmentA.IntersectionType());
 
 			Oint si = segmentA.startIndex();
 			Oint ei = segmentA.endIndex();
@@ -585,14 +2243,14 @@ namespace enterprise_manager {
 			case Segment<T>::VERTEX_VERTEX_VERTEX:
 			{
 													 //Mark as boundary
-													 polygonA.vertex()[si]->setStatus(BOUNDARY);
+													 MarkBoundary(polygonA.vertex()[si]);
 			}
 				break;
 			case Segment<T>::VERTEX_EDGE_VERTEX:
 			{
 												   //Mark as boundary
-												   polygonA.vertex()[si]->setStatus(BOUNDARY);
-												   polygonA.vertex()[ei]->setStatus(BOUNDARY);
+												   MarkBoundary(polygonA.vertex()[si]);
+												   MarkBoundary(polygonA.vertex()[ei]);
 			}
 				break;
 			case Segment<T>::VERTEX_EDGE_EDGE:
@@ -601,8 +2259,8 @@ namespace enterprise_manager {
 												 Vertex<T>* newVertexN = CreateEdgeVertex(intersectionLine, ei, segmentA.endDistance(), polygonA);
 
 												 //Mark as boundary
-												 polygonA.vertex()[si]->setStatus(BOUNDARY);
-												 newVertexN->setStatus(BOUNDARY);
+												 MarkBoundary(polygonA.vertex()[si]);
+												 MarkBoundary(newVertexN);
 
 												 //create 2 new polygons 
 												 Obool removePolygon = true;
@@ -626,8 +2284,8 @@ namespace enterprise_manager {
 			case Segment<T>::VERTEX_FACE_VERTEX:
 			{
 												   //Mark as boundary
-												   polygonA.vertex()[si]->setStatus(BOUNDARY);
-												   polygonA.vertex()[ei]->setStatus(BOUNDARY);
+												   MarkBoundary(polygonA.vertex()[si]);
+												   MarkBoundary(polygonA.vertex()[ei]);
 
 												   //create 2 new polygons
 												   Obool removePolygon = true;
@@ -643,8 +2301,8 @@ namespace enterprise_manager {
 												 Vertex<T>* newVertexN = CreateEdgeVertex(intersectionLine, ei, segmentA.endDistance(), polygonA);
 
 												 //Mark as boundary
-												 polygonA.vertex()[si]->setStatus(BOUNDARY);
-												 newVertexN->setStatus(BOUNDARY);
+												 MarkBoundary(polygonA.vertex()[si]);
+												 MarkBoundary(newVertexN);
 
 												 //create 2 new polygons
 												 Obool removePolygon = true;
@@ -662,8 +2320,8 @@ namespace enterprise_manager {
 												 Vertex<T>* newVertex = CreateFaceVertex(intersectionLine, segmentA.endDistance(), polygonA);
 
 												 //Mark as boundary
-												 polygonA.vertex()[si]->setStatus(BOUNDARY);
-												 newVertex->setStatus(BOUNDARY);
+												 MarkBoundary(polygonA.vertex()[si]);
+												 MarkBoundary(newVertex);
 
 												 Obool collinear = Vertex<T>::Collinear(newVertex, polygonA.vertex()[si], polygonA.vertex()[ei]);
 												 //two cases
@@ -691,8 +2349,8 @@ namespace enterprise_manager {
 												 Vertex<T>* newVertexN = CreateEdgeVertex(intersectionLine, si, segmentA.startDistance(), polygonA);
 
 												 //Mark as boundary
-												 polygonA.vertex()[ei]->setStatus(BOUNDARY);
-												 newVertexN->setStatus(BOUNDARY);
+												 MarkBoundary(polygonA.vertex()[ei]);
+												 MarkBoundary(newVertexN);
 
 												 //create 2 new polygons 
 												 Obool removePolygon = true;
@@ -720,7 +2378,7 @@ namespace enterprise_manager {
 												   Vertex<T>* newVertexN = CreateEdgeVertex(intersectionLine, si, segmentA.startDistance(), polygonA);
 
 												   //Mark as boundary
-												   newVertexN->setStatus(BOUNDARY);
+												   MarkBoundary(newVertexN);
 
 												   //create 2 new polygons
 												   Obool removePolygon = true;
@@ -735,8 +2393,8 @@ namespace enterprise_manager {
 												   Vertex<T>* newVertexM = CreateEdgeVertex(intersectionLine, ei, segmentA.endDistance(), polygonA);
 
 												   //Mark as boundary
-												   newVertexN->setStatus(BOUNDARY);
-												   newVertexM->setStatus(BOUNDARY);
+												   MarkBoundary(newVertexN);
+												   MarkBoundary(newVertexM);
 
 												   //assure newVertexN is nearest to si (B)
 												   Vec3<T> nVec = newVertexN->point() - polygonA.vertex()[si]->point();
@@ -764,8 +2422,8 @@ namespace enterprise_manager {
 												 Vertex<T>* newVertexN = CreateEdgeVertex(intersectionLine, si, segmentA.startDistance(), polygonA);
 
 												 //Mark as boundary
-												 polygonA.vertex()[ei]->setStatus(BOUNDARY);
-												 newVertexN->setStatus(BOUNDARY);
+												 MarkBoundary(polygonA.vertex()[ei]);
+												 MarkBoundary(newVertexN);
 
 												 //create 2 new polygons
 												 Obool removePolygon = true;
@@ -782,8 +2440,8 @@ namespace enterprise_manager {
 											   Vertex<T>* newVertexM = CreateEdgeVertex(intersectionLine, ei, segmentA.endDistance(), polygonA);
 
 											   //Mark as boundary
-											   newVertexN->setStatus(BOUNDARY);
-											   newVertexM->setStatus(BOUNDARY);
+											   MarkBoundary(newVertexN);
+											   MarkBoundary(newVertexM);
 
 											   if (newVertexN == newVertexM)
 												   newVertexM = NULL;
@@ -803,8 +2461,8 @@ namespace enterprise_manager {
 											   Vertex<T>* newVertexM = CreateFaceVertex(intersectionLine, segmentA.endDistance(), polygonA);
 
 											   //Mark as boundary
-											   newVertexN->setStatus(BOUNDARY);
-											   newVertexM->setStatus(BOUNDARY);
+											   MarkBoundary(newVertexN);
+											   MarkBoundary(newVertexM);
 
 											   Obool removePolygon = true;
 
@@ -834,8 +2492,8 @@ namespace enterprise_manager {
 												 Vertex<T>* newVertex = CreateFaceVertex(intersectionLine, segmentA.startDistance(), polygonA);
 
 												 //Mark as boundary
-												 polygonA.vertex()[ei]->setStatus(BOUNDARY);
-												 newVertex->setStatus(BOUNDARY);
+												 MarkBoundary(polygonA.vertex()[ei]);
+												 MarkBoundary(newVertex);
 
 												 Obool removePolygon = true;
 
@@ -865,8 +2523,8 @@ namespace enterprise_manager {
 											   Vertex<T>* newVertexM = CreateFaceVertex(intersectionLine, segmentA.startDistance(), polygonA);
 
 											   //Mark as boundary
-											   newVertexN->setStatus(BOUNDARY);
-											   newVertexM->setStatus(BOUNDARY);
+											   MarkBoundary(newVertexN);
+											   MarkBoundary(newVertexM);
 
 											   Obool removePolygon = true;
 
@@ -899,7 +2557,7 @@ namespace enterprise_manager {
 												   Vertex<T>* newVertexN = CreateFaceVertex(intersectionLine, segmentA.startDistance(), polygonA);
 
 												   //Mark as boundary
-												   newVertexN->setStatus(BOUNDARY);
+												   MarkBoundary(newVertexN);
 
 												   if (startOnIntersectionLine && endOnIntersectionLine) {
 													   //create 6 new polygons
@@ -939,8 +2597,8 @@ namespace enterprise_manager {
 												   Vertex<T>* newVertexM = CreateFaceVertex(intersectionLine, segmentA.endDistance(), polygonA);
 
 												   //Mark as boundary
-												   newVertexN->setStatus(BOUNDARY);
-												   newVertexM->setStatus(BOUNDARY);
+												   MarkBoundary(newVertexN);
+												   MarkBoundary(newVertexM);
 												   if (startOnIntersectionLine && endOnIntersectionLine) {
 													   //create 6 new polygons
 													   removePolygon &= CreateSubPolygon(polygonA, polygonA.NextIndex(ei), polygonA.PrevIndex(si), newVertexN, newVertexM);
@@ -1030,8 +2688,11 @@ namespace enterprise_manager {
 		Object<T>::GetCreateVertex(const Vec3<T>& point) {
 			Vertex<T>* newVertex = GetExistingVertex(point);
 			if (!newVertex) {
-				newVertex = new Vertex<T>(point);
+				newVertex = NewVertex(point);
 				_vertex.push_back(newVertex);
+				Context<T>& context = Context<T>::current();
+				if (context.detailedStatistics)
+					++context.statistics.createdVertices;
 			}
 			return newVertex;
 		}
@@ -1040,14 +2701,46 @@ namespace enterprise_manager {
 	Vertex<T>*
 		Object<T>::GetExistingVertex(const Vec3<T>& point) {
 			//test if point already exists in Object
-			for (Ouint i = 0; i < _vertex.size(); ++i) {
-				if (_vertex[i]->point().Equal(point, Vertex<T>::tolerance)) {
-					return _vertex[i];
+			Context<T>& context = Context<T>::current();
+			if (_scratch != NULL) {
+				//the vertices of the object split come first, as they have the lower indexes there
+				const Object& object = *_scratch->object;
+				Oint index = object._vertexGrid.Find(object._vertex, point);
+				if (index != -1) {
+					if (context.detailedStatistics)
+						++context.statistics.existingVertices;
+					return object._vertex[index];
+				}
+				_scratch->points.push_back(point);
+				for (Ouint i = _scratch->firstVertex; i < _vertex.size(); ++i) {
+					if (_vertex[i]->point().Equal(point, context.tolerance)) {
+						if (context.detailedStatistics)
+							++context.statistics.existingVertices;
+						return _vertex[i];
+					}
 				}
+				return NULL;
+			}
+			_vertexGrid.Update(_vertex, context.tolerance);
+			Oint index = _vertexGrid.Find(_vertex, point);
+			if (index != -1) {
+				if (context.detailedStatistics)
+					++context.statistics.existingVertices;
+				return _vertex[index];
 			}
 			return NULL;
 		}
 
+	template <class T>
+	void
+		Object<T>::MarkBoundary(Vertex<T>* vertex) {
+			if (_scratch != NULL && std::find(_vertex.begin() + _scratch->firstVertex, _vertex.end(), vertex) == _vertex.end()) {
+				_scratch->boundary.push_back(vertex);
+				return;
+			}
+			vertex->setStatus(BOUNDARY);
+		}
+
 	template <class T>
 	Obool
 		Object<T>::AddSubPolygon(Polygon<T>& oldPolygon, Polygon<T>* subPolygon) {
@@ -1055,7 +2748,7 @@ namespace enterprise_manager {
 				return true; //WTF? We did not add any polygon, so why does the result of operation equal true?
 
 			if (subPolygon->IsEqual(oldPolygon)) {
-				delete subPolygon;
+				DeletePolygon(subPolygon);
 				subPolygon = NULL;
 				return false;
 			}
@@ -1088,9 +2781,9 @@ namespace enterprise_manager {
 				vertex.push_back(newVertex2);
 
 			if (vertex.size() > 2) {
-				Polygon<T>* newPolygon = new Polygon<T>(vertex, 0);
+				Polygon<T>* newPolygon = NewPolygon(vertex, 0);
 				return AddSubPolygon(oldPolygon, newPolygon);
-				delete newPolygon;
+				DeletePolygon(newPolygon);
 			}
 			return false;
 		}
@@ -1098,11 +2791,16 @@ namespace enterprise_manager {
 	template <class T>
 	void
 		Object<T>::RemovePolygon(Polygon<T>* polygon) {
+			//a scratch object does not own the polygon it subdivides
+			if (_scratch != NULL && polygon == _scratch->polygon) {
+				_scratch->removed = true;
+				return;
+			}
 			Ouint polygonIndex = polygon->index();
 			if ((polygonIndex < _polygon.size()) && (polygonIndex >= 0)) {
 				Polygon<T>* polyAtIndex = _polygon[polygonIndex];
 				if (polyAtIndex == polygon) { // verify polygon is the same
-					delete polyAtIndex;
+					DeletePolygon(polyAtIndex);
 					_polygon[polygonIndex] = NULL;
 					return;
 				}
@@ -1111,20 +2809,24 @@ namespace enterprise_manager {
 			//if not found by index, search by element
 			std::vector<Polygon<T>*>::iterator it = std::find(_polygon.begin(), _polygon.end(), polygon);
 			if (it != _polygon.end()) {
-				delete *it;
+				DeletePolygon(*it);
 				(*it) = NULL;
 			}
 		}
 
 	template <class T>
 	void
-		Object<T>::CleanPolygonList() {
+		Object<T>::CleanPolygonList(std::vector<Obool>* flags) {
 			//clean up
 			Ouint i = 0;
 			while (i < _polygon.size()) {
 				if (_polygon[i] == NULL) {
 					_polygon[i] = _polygon.back();
 					_polygon.pop_back();
+					if (flags != NULL) {
+						(*flags)[i] = flags->back();
+						flags->pop_back();
+					}
 				}
 				else {
 					++i;
@@ -1150,42 +2852,49 @@ namespace enterprise_manager {
 
 			Obool polygonAMeaning = polygonA.IsMeaning();
 
-			for (Oint i = 0; i < _polygon.size(); ++i) {
-				Polygon<T>& polygonB = *_polygon[i];
-				T distance = Polygon<T>::PlaneToPointDistance(polygonB, barycenter);
+			//polygons the ray cannot reach can neither contain the barycenter nor be hit
+			Context<T>& context = Context<T>::current();
+			std::vector<Oint>& candidates = context.rayPolygons;
+			FindRayCandidates(barycenter, rayFromA, T(0), candidates);
+			++context.statistics.rayCasts;
+			context.statistics.rayPolygons += candidates.size();
+
+			for (Ouint k = 0; k < candidates.size(); ++k) {
+				Oint i = candidates[k];
+				T distance = _mesh.PlaneToPointDistance(i, barycenter);
 
-				Obool orderOfTolerance = !polygonB.IsMeaning() || !polygonAMeaning;
+				Obool orderOfTolerance = !_mesh.IsMeaning(i) || !polygonAMeaning;
 
 				//If no polygon is meaning (i.e. both polygons greater than order of tolerance than compare as always otherwise use epsilon as tolerance
-				if ((!orderOfTolerance && EQ(distance, T(0), Vertex<T>::tolerance)) ||
-					(orderOfTolerance && EQ(distance, T(0), Vertex<T>::epsilonValue))) { //polygons are the same or lay in one plane (cannot intersect!)
-					RELPOS_STATUS relPosB = polygonB.FindRelativePosition(barycenter);
+				if ((!orderOfTolerance && EQ(distance, T(0), context.tolerance)) ||
+					(orderOfTolerance && EQ(distance, T(0), context.epsilonValue))) { //polygons are the same or lay in one plane (cannot intersect!)
+					RELPOS_STATUS relPosB = _mesh.FindRelativePosition(i, barycenter);
 					if (relPosB == INSIDE || relPosB == BOUNDARY) {
 						//find the DOT PRODUCT of RAY direction with the normal of polygonB
-						T dotProduct = rayFromA*polygonB.normal();
+						T dotProduct = rayFromA*_mesh.normal(i);
 						// according to the algorithm 
-						if (GE(dotProduct, T(0), Vertex<T>::tolerance)) {
+						if (GE(dotProduct, T(0), context.tolerance)) {
 							return SAME;
 						}
-						else if (LT(dotProduct, T(0), Vertex<T>::tolerance)) {
+						else if (LT(dotProduct, T(0), context.tolerance)) {
 							return OPPOSITE;
 						}
 					}
 				}
 				else {
 					//find intersection dist of ray with plane of polygonB
-					T intDist = polygonB.IntersectRayWithPlane(barycenter, rayFromA);
+					T intDist = _mesh.IntersectRayWithPlane(i, barycenter, rayFromA);
 
-					T dotProduct = rayFromA * polygonB.normal();
-					Obool isDotZero = EQ(dotProduct, T(0), Vertex<T>::tolerance);
-					Obool isDistancePositive = GT(distance, T(0), Vertex<T>::tolerance);
+					T dotProduct = rayFromA * _mesh.normal(i);
+					Obool isDotZero = EQ(dotProduct, T(0), context.tolerance);
+					Obool isDistancePositive = GT(distance, T(0), context.tolerance);
 
-					if (LT(intDist, T(0), Vertex<T>::tolerance) || (isDotZero && isDistancePositive)) {
+					if (LT(intDist, T(0), context.tolerance) || (isDotZero && isDistancePositive)) {
 						continue;//parallel or behind the polygonA
 					}
 
 					Vec3<T> intersection = barycenter + rayFromA*intDist;
-					RELPOS_STATUS pos = polygonB.FindRelativePosition(intersection);
+					RELPOS_STATUS pos = _mesh.FindRelativePosition(i, intersection);
 					if (pos == OUTSIDE)
 						continue;
 
@@ -1216,10 +2925,10 @@ namespace enterprise_manager {
 
 			T dotProduct = rayFromA*closestPolygons[selectedPolygon]->normal();
 			// according to the algorithm 
-			if (GT(dotProduct, T(0), Vertex<T>::tolerance)) {
+			if (GT(dotProduct, T(0), context.tolerance)) {
 				return INSIDE;
 			}
-			else if (LT(dotProduct, T(0), Vertex<T>::tolerance)) {
+			else if (LT(dotProduct, T(0), context.tolerance)) {
 				return OUTSIDE;
 			}
 		}
@@ -1276,13 +2985,17 @@ namespace enterprise_manager {
 		Object<T>::MakeCcwEx() {
 			if (_polygon.size() == 0)
 				return;
+			O_TRACE_SCOPE("MakeCcw");
 			Vec3<T> randVec(0, 0, 0);
 			Oint counter = 0;
 			RELPOS_STATUS pos_status = UNKNOWN;
+			//one ray per polygon, so the hierarchy pays off here unlike in MakeCcw
+			BuildHierarchy();
 			for (int p = 0; p < _polygon.size(); p++) {
 				Polygon<T>& polygonA = *_polygon[p];
 				_MakeCcw(polygonA);
 			}
+			ClearHierarchy();
 		}
 
 	template <class T>
@@ -1290,9 +3003,13 @@ namespace enterprise_manager {
 		Object<T>::MakeCcw() {
 			if (_polygon.size() == 0)
 				return;
+			O_TRACE_SCOPE("MakeCcw");
+			PhaseTimer<T> timer(Context<T>::current(), Context<T>::Statistics::MAKE_CCW);
 			Oint counter = 0;
 			const Polygon<T>& polygonA = *_polygon[0];
+			_mesh.Build(_vertex, _polygon);
 			_MakeCcw(polygonA);
+			_mesh.Clear();
 		}
 
 	template <class T>
@@ -1306,19 +3023,24 @@ namespace enterprise_manager {
 			RELPOS_STATUS pos_status = UNKNOWN;
 			std::map<Ouint, vector<Polygon<T>*>> adjacentPolygons;
 			Ouint adjacentGroup = 0;
-			for (Ouint i = 1; i < _polygon.size(); i++) {
-				const Polygon<T>& polygonB = *_polygon[i];
-				T distance = Polygon<T>::PlaneToPointDistance(polygonB, barycenter);
-				if (EQ(distance, T(0), Vertex<T>::tolerance)) {
+			std::vector<Oint>& candidates = Context<T>::current().rayPolygons;
+			FindRayCandidates(barycenter, rayFromA, T(0), candidates);
+			for (Ouint k = 0; k < candidates.size(); k++) {
+				Ouint i = candidates[k];
+				if (i == 0)
+					continue;
+				T distance = _mesh.PlaneToPointDistance(i, barycenter);
+				if (EQ(distance, T(0), Context<T>::current().tolerance)) {
 					continue;
 				}
-				T intDist = polygonB.IntersectRayWithPlane(barycenter, rayFromA);
-				if (LE(intDist, T(0), Vertex<T>::tolerance)) {
+				T intDist = _mesh.IntersectRayWithPlane(i, barycenter, rayFromA);
+				if (LE(intDist, T(0), Context<T>::current().tolerance)) {
 					continue;
 				}
 				Vec3<T> intersection = barycenter + rayFromA*intDist;
-				pos_status = polygonB.FindRelativePosition(intersection);
+				pos_status = _mesh.FindRelativePosition(i, intersection);
 				if (pos_status == BOUNDARY) {
+					const Polygon<T>& polygonB = *_polygon[i];
 					//Look for appropriate adjacent group
 					Obool isNewAdjacentGroup = true;
 					for (map<Ouint, vector<Polygon<T>*>>::iterator it = adjacentPolygons.begin(); it != adjacentPolygons.end() && isNewAdjacentGroup; ++it) {
@@ -1364,6 +3086,8 @@ namespace enterprise_manager {
 					_polygon[j]->Reverse();
 					_polygon[j]->CalculatePlaneEquation();
 				}
+				//the following rays of MakeCcwEx must see the new planes
+				_mesh.Build(_vertex, _polygon);
 			}
 		}
 
@@ -1517,7 +3241,7 @@ namespace enterprise_manager {
 				}
 			}
 
-			//perimeters[i].second = pn->Equal(normal, Vertex<T>::unitTolerance);
+			//perimeters[i].second = pn->Equal(normal, Context<T>::current().unitTolerance);
 			perimeters[i].second = angle >= 0;
 			perimeter.push_back(-1);
 			perimeters[i].first = perimeter;
@@ -1589,9 +3313,9 @@ namespace enterprise_manager {
 		Object<T>::AddPolygon(vector<Vertex<T>*> vertices) {
 			for (Ouint i = 0; i < vertices.size(); ++i) {
 				Vec3<T> v = vertices[i]->point();
-				_vertex.push_back(new Vertex<T>(v));
+				_vertex.push_back(NewVertex(v));
 			}
-			_polygon.push_back(new Polygon<T>(vertices, _polygon.size()));
+			_polygon.push_back(NewPolygon(vertices, _polygon.size()));
 			CalculateExtents();
 		}
 #endif
@@ -0,0 +1,6 @@
+#include "config.h"
+#include "Parallel.h"
+
+namespace enterprise_manager {
+
+} // namespace enterprise_manager
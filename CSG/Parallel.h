@@ -0,0 +1,71 @@
+#ifndef CSG_PARALLEL_H
+#define CSG_PARALLEL_H
+
+#include "config.h"
+#include "Context.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace enterprise_manager {
+
+	// Call function(first, last) for consecutive ranges of at most grainSize
+	// elements covering [0, count). With more than one thread in the current
+	// context the ranges are processed by worker threads, each running in its own
+	// context with the settings of the current context, otherwise function is
+	// called once for the whole range on the calling thread. The statistics of the
+	// workers are added to the current context, and an abort of a worker aborts the
+	// current context. The function must not depend on
+	// which thread processes a range, so the results do not depend on the number
+	// of threads.
+	template <class T, class Function>
+	void                        ParallelFor(Ouint count, Ouint grainSize, Function function);
+
+	// The class WorkerPool keeps the threads of ParallelFor alive for its lifetime,
+	// so a pass running a parallel loop again and again, as SplitBy does for each
+	// generation of polygons, does not start and join threads for every loop. The
+	// pool takes the thread count and settings of the current context when it is
+	// constructed. The statistics of the workers are added to that context when the
+	// pool is destroyed, an abort of a worker aborts it at the end of the loop.
+	template <class T> class WorkerPool {
+	public:
+		// Start the workers, at most maxThreads of them.
+		explicit                WorkerPool(Ouint maxThreads = 0);
+		virtual                 ~WorkerPool();
+
+		// The number of threads the loops run on, the calling thread included.
+		Ouint                   threadCount() const;
+
+		// Call function(thread, first, last) for the ranges of ParallelFor, where
+		// thread, below threadCount, tells which thread processes the range.
+		template <class Function>
+		void                    For(Ouint count, Ouint grainSize, Function function);
+
+	private:
+		WorkerPool(const WorkerPool&);
+		WorkerPool&             operator=(const WorkerPool&);
+
+		void                    Work(Ouint thread);
+
+		Context<T>&             _context;
+		std::vector<Context<T> > _workerContext;
+		std::vector<std::thread> _thread;
+
+		// The loop being run, handed out to the workers by _loop.
+		std::mutex              _mutex;
+		std::condition_variable _start;
+		std::condition_variable _done;
+		std::function<void(Ouint)> _run;
+		Ouint                   _loop;
+		Ouint                   _running;
+		Obool                   _stop;
+	};
+
+} // namespace enterprise_manager
+
+#include "Parallel.inl"
+
+#endif // CSG_PARALLEL_H
@@ -0,0 +1,129 @@
+namespace enterprise_manager {
+
+	template <class T, class Function>
+	void
+		ParallelFor(Ouint count, Ouint grainSize, Function function) {
+			if (count == 0)
+				return;
+			if (grainSize == 0)
+				grainSize = 1;
+			WorkerPool<T> pool((count + grainSize - 1) / grainSize);
+			pool.For(count, grainSize, [&](Ouint thread, Ouint first, Ouint last) {
+				function(first, last);
+			});
+		}
+
+	template <class T>
+	WorkerPool<T>::WorkerPool(Ouint maxThreads)
+		: _context(Context<T>::current()),
+		_loop(0),
+		_running(0),
+		_stop(false) {
+		Ouint threadCount = _context.threadCount;
+		if (maxThreads > 0)
+			threadCount = O_MIN(threadCount, maxThreads);
+		if (threadCount <= 1)
+			return;
+
+		_workerContext.resize(threadCount);
+		for (Ouint i = 0; i < threadCount; ++i) {
+			_workerContext[i].CopySettings(_context);
+		}
+		//the calling thread is worker 0
+		for (Ouint i = 1; i < threadCount; ++i) {
+			_thread.push_back(std::thread(&WorkerPool::Work, this, i));
+		}
+	}
+
+	template <class T>
+	/* virtual */
+	WorkerPool<T>::~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_start.notify_all();
+		for (Ouint i = 0; i < _thread.size(); ++i) {
+			_thread[i].join();
+		}
+		for (Ouint i = 0; i < _workerContext.size(); ++i) {
+			_context.statistics.Add(_workerContext[i].statistics);
+		}
+	}
+
+	template <class T>
+	Ouint
+		WorkerPool<T>::threadCount() const {
+			return _workerContext.empty() ? 1 : (Ouint)_workerContext.size();
+		}
+
+	template <class T>
+	template <class Function>
+	void
+		WorkerPool<T>::For(Ouint count, Ouint grainSize, Function function) {
+			if (grainSize == 0)
+				grainSize = 1;
+			if (_workerContext.empty()) {
+				if (count > 0)
+					function(0, 0, count);
+				return;
+			}
+
+			//the ranges are handed out one by one, so threads finishing early take over the remaining work
+			Ouint rangeCount = (count + grainSize - 1) / grainSize;
+			std::atomic<Ouint> nextRange(0);
+			auto run = [&](Ouint thread) {
+				for (Ouint range = nextRange++; range < rangeCount; range = nextRange++) {
+					Ouint first = range * grainSize;
+					function(thread, first, O_MIN(first + grainSize, count));
+				}
+			};
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_run = run;
+				_running = (Ouint)_thread.size();
+				++_loop;
+			}
+			_start.notify_all();
+			{
+				ContextScope<T> scope(_workerContext[0]);
+				run(0);
+			}
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_done.wait(lock, [this] { return _running == 0; });
+				_run = nullptr;
+			}
+
+			for (Ouint i = 0; i < _workerContext.size(); ++i) {
+				if (_workerContext[i].aborted())
+					_context.Abort(_workerContext[i].abortReason);
+			}
+		}
+
+	template <class T>
+	void
+		WorkerPool<T>::Work(Ouint thread) {
+			ContextScope<T> scope(_workerContext[thread]);
+			Ouint loop = 0;
+			for (;;) {
+				std::function<void(Ouint)> run;
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_start.wait(lock, [&] { return _stop || _loop != loop; });
+					if (_stop)
+						return;
+					loop = _loop;
+					run = _run;
+				}
+				run(thread);
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					if (--_running == 0)
+						_done.notify_one();
+				}
+			}
+		}
+
+} // namespace enterprise_manager
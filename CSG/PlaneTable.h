@@ -0,0 +1,72 @@
+#ifndef CSG_PLANETABLE_H
+#define CSG_PLANETABLE_H
+
+#include "Vertex.h"
+#include "Extent.h"
+#include <vector>
+#if defined(O_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(O_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace enterprise_manager {
+
+	template <class T> class Polygon;
+
+	// The class PlaneTable keeps the planes and extents of the polygons of an
+	// Object in flat arrays, one per component, so a polygon can be tested against
+	// many of them at once with vector instructions. It rejects the pairs whose
+	// extents overlap but which cannot intersect because the plane of one polygon
+	// has the other polygon wholly on one side.
+	template <class T> class PlaneTable {
+	public:
+		PlaneTable();
+		virtual                 ~PlaneTable();
+
+		// Fill the table with the planes and extents of the polygons.
+		void                    Build(const std::vector<Polygon<T>*>& polygons);
+
+		void                    Clear();
+
+		inline Ouint            size() const;
+
+		// Remove from candidates, indexes into the table, the polygons which cannot
+		// intersect polygon: those whose extent lies on one side of the plane of
+		// polygon, or on whose plane the extent of polygon lies on one side. Sides
+		// are taken beyond twice the tolerance, so a polygon having a vertex within
+		// the tolerance of the plane of the other is never removed. The candidates
+		// keep their order. Returns the number of removed candidates.
+		Ouint                   RejectSeparated(const Polygon<T>& polygon, T tolerance, std::vector<Oint>& candidates) const;
+
+	private:
+		// The plane and extent of the polygon tested against the table.
+		struct Query {
+			T                   normal[3];
+			T                   absNormal[3];
+			T                   d;
+			T                   center[3];
+			T                   half[3];
+			T                   margin;
+		};
+
+		inline Obool            Separated(const Query& query, Oint index) const;
+
+		// Test the candidates [0, count) with vector instructions in blocks, moving
+		// the kept ones to the front. Returns the number of candidates tested, the
+		// rest is left to the scalar loop. Specialized for double.
+		Ouint                   SeparatedBlocks(const Query& query, Oint* candidates, Ouint count, Ouint& kept) const;
+
+		// Plane equation ax+by+cz+d = 0 of each polygon.
+		std::vector<T>          _normal[3];
+		std::vector<T>          _d;
+		// Center and half size of the extent of each polygon.
+		std::vector<T>          _center[3];
+		std::vector<T>          _half[3];
+	};
+
+} // namespace enterprise_manager
+
+#include "PlaneTable.inl"
+
+#endif // CSG_PLANETABLE_H
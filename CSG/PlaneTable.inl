@@ -0,0 +1,187 @@
+namespace enterprise_manager {
+
+	template <class T>
+	PlaneTable<T>::PlaneTable() {}
+
+	template <class T>
+	/* virtual */
+	PlaneTable<T>::~PlaneTable() {}
+
+	template <class T>
+	inline Ouint
+		PlaneTable<T>::size() const {
+			return (Ouint)_d.size();
+		}
+
+	template <class T>
+	void
+		PlaneTable<T>::Clear() {
+			for (Oint axis = 0; axis < 3; ++axis) {
+				_normal[axis].clear();
+				_center[axis].clear();
+				_half[axis].clear();
+			}
+			_d.clear();
+		}
+
+	template <class T>
+	void
+		PlaneTable<T>::Build(const std::vector<Polygon<T>*>& polygons) {
+			Ouint count = (Ouint)polygons.size();
+			for (Oint axis = 0; axis < 3; ++axis) {
+				_normal[axis].resize(count);
+				_center[axis].resize(count);
+				_half[axis].resize(count);
+			}
+			_d.resize(count);
+			for (Ouint i = 0; i < count; ++i) {
+				const Polygon<T>& polygon = *polygons[i];
+				const Vec3<T>& min = polygon.extent().min();
+				const Vec3<T>& max = polygon.extent().max();
+				for (Oint axis = 0; axis < 3; ++axis) {
+					_normal[axis][i] = polygon.normal()[axis];
+					_center[axis][i] = (min[axis] + max[axis]) / 2;
+					_half[axis][i] = (max[axis] - min[axis]) / 2;
+				}
+				_d[i] = polygon.d();
+			}
+		}
+
+	template <class T>
+	Ouint
+		PlaneTable<T>::RejectSeparated(const Polygon<T>& polygon, T tolerance, std::vector<Oint>& candidates) const {
+			Query query;
+			const Vec3<T>& min = polygon.extent().min();
+			const Vec3<T>& max = polygon.extent().max();
+			for (Oint axis = 0; axis < 3; ++axis) {
+				query.normal[axis] = polygon.normal()[axis];
+				query.absNormal[axis] = fabs(query.normal[axis]);
+				query.center[axis] = (min[axis] + max[axis]) / 2;
+				query.half[axis] = (max[axis] - min[axis]) / 2;
+			}
+			query.d = polygon.d();
+			query.margin = 2 * tolerance;
+
+			Ouint count = (Ouint)candidates.size();
+			if (count == 0)
+				return 0;
+			Ouint kept = 0;
+			Ouint i = SeparatedBlocks(query, &candidates[0], count, kept);
+			for (; i < count; ++i) {
+				if (!Separated(query, candidates[i]))
+					candidates[kept++] = candidates[i];
+			}
+			candidates.resize(kept);
+			return count - kept;
+		}
+
+	template <class T>
+	inline Obool
+		PlaneTable<T>::Separated(const Query& query, Oint index) const {
+			//the extent of the polygon of the table against the plane of the query polygon
+			T distance = query.normal[0] * _center[0][index] + query.normal[1] * _center[1][index] + query.normal[2] * _center[2][index] + query.d;
+			T radius = query.absNormal[0] * _half[0][index] + query.absNormal[1] * _half[1][index] + query.absNormal[2] * _half[2][index];
+			if (fabs(distance) - radius > query.margin)
+				return true;
+			//the extent of the query polygon against the plane of the polygon of the table
+			distance = _normal[0][index] * query.center[0] + _normal[1][index] * query.center[1] + _normal[2][index] * query.center[2] + _d[index];
+			radius = fabs(_normal[0][index]) * query.half[0] + fabs(_normal[1][index]) * query.half[1] + fabs(_normal[2][index]) * query.half[2];
+			return fabs(distance) - radius > query.margin;
+		}
+
+	template <class T>
+	Ouint
+		PlaneTable<T>::SeparatedBlocks(const Query& /*query*/, Oint* /*candidates*/, Ouint /*count*/, Ouint& /*kept*/) const {
+			return 0;
+		}
+
+#if defined(O_SIMD_AVX2)
+	template <>
+	inline Ouint
+		PlaneTable<double>::SeparatedBlocks(const Query& query, Oint* candidates, Ouint count, Ouint& kept) const {
+			const __m256d signMask = _mm256_set1_pd(-0.0);
+			const __m256d margin = _mm256_set1_pd(query.margin);
+			Ouint i = 0;
+			for (; i + 4 <= count; i += 4) {
+				Oint index[4] = { candidates[i], candidates[i + 1], candidates[i + 2], candidates[i + 3] };
+				__m128i gather = _mm_loadu_si128((const __m128i*)index);
+				__m256d normal[3], center[3], half[3];
+				for (Oint axis = 0; axis < 3; ++axis) {
+					normal[axis] = _mm256_i32gather_pd(&_normal[axis][0], gather, 8);
+					center[axis] = _mm256_i32gather_pd(&_center[axis][0], gather, 8);
+					half[axis] = _mm256_i32gather_pd(&_half[axis][0], gather, 8);
+				}
+				__m256d d = _mm256_i32gather_pd(&_d[0], gather, 8);
+
+				//the extents of the table against the plane of the query polygon
+				__m256d distance = _mm256_set1_pd(query.d);
+				__m256d radius = _mm256_setzero_pd();
+				for (Oint axis = 0; axis < 3; ++axis) {
+					distance = _mm256_add_pd(distance, _mm256_mul_pd(_mm256_set1_pd(query.normal[axis]), center[axis]));
+					radius = _mm256_add_pd(radius, _mm256_mul_pd(_mm256_set1_pd(query.absNormal[axis]), half[axis]));
+				}
+				__m256d separated = _mm256_cmp_pd(_mm256_sub_pd(_mm256_andnot_pd(signMask, distance), radius), margin, _CMP_GT_OQ);
+
+				//the extent of the query polygon against the planes of the table
+				distance = d;
+				radius = _mm256_setzero_pd();
+				for (Oint axis = 0; axis < 3; ++axis) {
+					distance = _mm256_add_pd(distance, _mm256_mul_pd(normal[axis], _mm256_set1_pd(query.center[axis])));
+					radius = _mm256_add_pd(radius, _mm256_mul_pd(_mm256_andnot_pd(signMask, normal[axis]), _mm256_set1_pd(query.half[axis])));
+				}
+				separated = _mm256_or_pd(separated, _mm256_cmp_pd(_mm256_sub_pd(_mm256_andnot_pd(signMask, distance), radius), margin, _CMP_GT_OQ));
+
+				Oint mask = _mm256_movemask_pd(separated);
+				for (Oint lane = 0; lane < 4; ++lane) {
+					if (!(mask & (1 << lane)))
+						candidates[kept++] = index[lane];
+				}
+			}
+			return i;
+		}
+#elif defined(O_SIMD_SSE2)
+	template <>
+	inline Ouint
+		PlaneTable<double>::SeparatedBlocks(const Query& query, Oint* candidates, Ouint count, Ouint& kept) const {
+			const __m128d signMask = _mm_set1_pd(-0.0);
+			const __m128d margin = _mm_set1_pd(query.margin);
+			Ouint i = 0;
+			for (; i + 2 <= count; i += 2) {
+				Oint index[2] = { candidates[i], candidates[i + 1] };
+				__m128d normal[3], center[3], half[3];
+				for (Oint axis = 0; axis < 3; ++axis) {
+					normal[axis] = _mm_set_pd(_normal[axis][index[1]], _normal[axis][index[0]]);
+					center[axis] = _mm_set_pd(_center[axis][index[1]], _center[axis][index[0]]);
+					half[axis] = _mm_set_pd(_half[axis][index[1]], _half[axis][index[0]]);
+				}
+				__m128d d = _mm_set_pd(_d[index[1]], _d[index[0]]);
+
+				//the extents of the table against the plane of the query polygon
+				__m128d distance = _mm_set1_pd(query.d);
+				__m128d radius = _mm_setzero_pd();
+				for (Oint axis = 0; axis < 3; ++axis) {
+					distance = _mm_add_pd(distance, _mm_mul_pd(_mm_set1_pd(query.normal[axis]), center[axis]));
+					radius = _mm_add_pd(radius, _mm_mul_pd(_mm_set1_pd(query.absNormal[axis]), half[axis]));
+				}
+				__m128d separated = _mm_cmpgt_pd(_mm_sub_pd(_mm_andnot_pd(signMask, distance), radius), margin);
+
+				//the extent of the query polygon against the planes of the table
+				distance = d;
+				radius = _mm_setzero_pd();
+				for (Oint axis = 0; axis < 3; ++axis) {
+					distance = _mm_add_pd(distance, _mm_mul_pd(normal[axis], _mm_set1_pd(query.center[axis])));
+					radius = _mm_add_pd(radius, _mm_mul_pd(_mm_andnot_pd(signMask, normal[axis]), _mm_set1_pd(query.half[axis])));
+				}
+				separated = _mm_or_pd(separated, _mm_cmpgt_pd(_mm_sub_pd(_mm_andnot_pd(signMask, distance), radius), margin));
+
+				Oint mask = _mm_movemask_pd(separated);
+				for (Oint lane = 0; lane < 2; ++lane) {
+					if (!(mask & (1 << lane)))
+						candidates[kept++] = index[lane];
+				}
+			}
+			return i;
+		}
+#endif
+
+} // namespace enterprise_manager
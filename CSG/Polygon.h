@@ -8,6 +8,8 @@
 namespace enterprise_manager {
 
 	template <class T> class Segment;
+	template <class T> class Mesh;
+	template <class T> class PlaneTable;
 
 	typedef enum {
 		COPLANAR = 0,
@@ -41,6 +43,8 @@ namespace enterprise_manager {
 	template <class T> class Polygon {
 		friend class Object<T>;
 		friend class Segment<T>;
+		friend class Mesh<T>;
+		friend class PlaneTable<T>;
 
 	public:
 		Obool                   IsPlanar() const;
@@ -77,6 +81,9 @@ namespace enterprise_manager {
 		inline const std::vector<Vertex<T>*>&
 			vertex() const;
 
+		inline const Extent<T>&
+			extent() const;
+
 		explicit                Polygon(const std::vector<Vertex<T>*>& vertices, Oint index);
 
 		Obool                   IsCoplanar(const Polygon<T>* other);
@@ -91,6 +98,9 @@ namespace enterprise_manager {
 
 	protected:
 		explicit                Polygon(const std::vector<Vertex<T>*>& vertices, Oint index, const Polygon<T>& original);
+		// Copy original with the specified vertices, which must be at the same points.
+		// The plane equation, extent and area are copied instead of being calculated.
+		explicit                Polygon(const Polygon<T>& original, const std::vector<Vertex<T>*>& vertices);
 		virtual                 ~Polygon();
 
 		Obool                   IsEqual(const Polygon<T>& other) const;
@@ -102,6 +112,8 @@ namespace enterprise_manager {
 
 		// Calculate polygon extents.
 		void                    CalculateExtents();
+		// Calculates plane equation and extents, reading each vertex once for both.
+		void                    CalculatePlaneEquationAndExtents();
 
 		// Find the distance from pointB to the plane defined by polygonA.
 		static T                PlaneToPointDistance(const Polygon<T>& polygonA, const Vec3<T>& pointB);
@@ -128,8 +140,14 @@ namespace enterprise_manager {
 		// Find the position of a specified point relative to this polygon (INSIDE,
 		// OUTSIDE or BOUNDARY).
 		RELPOS_STATUS           FindRelativePosition(const Vec3<T>& point) const;
-		void                    FindProjectionAxes(const Vec3<T>& normal, Ochar& ix, Ochar& iy) const;
-		RELPOS_STATUS           _RelativePosition(const Vec3<T> &point, Ochar iy, Ochar ix) const;
+		static void             FindProjectionAxes(const Vec3<T>& normal, Ochar& ix, Ochar& iy);
+
+		// Find the position of a point relative to the polygon with the specified
+		// normal whose vertices are points[0] to points[size - 1]. Points is any
+		// type whose operator[] returns the point of a vertex, so the test runs on
+		// the vertices of a Polygon as well as on the arrays of a Mesh.
+		template <class Points>
+		static RELPOS_STATUS    RelativePosition(const Points& points, Ouint size, const Vec3<T>& normal, const Vec3<T>& point);
 
 		Obool                   IsInsideTriangle(const Vec3<T>& requiredPoint,
 			const Vec3<T>& firstVertex,
@@ -152,9 +170,6 @@ namespace enterprise_manager {
 		// if index is zero).
 		inline Ouint            NextIndex(Ouint index) const;
 
-		inline const Extent<T>&
-			extent() const;
-
 		inline const Vec3<T>&   normal() const;
 
 		inline const T          d() const;
@@ -180,6 +195,32 @@ namespace enterprise_manager {
 	private:
 		Polygon();
 
+		// The points of the vertices of a polygon for RelativePosition.
+		struct VertexPoints {
+			const std::vector<Vertex<T>*>& vertex;
+
+			VertexPoints(const std::vector<Vertex<T>*>& vertex) : vertex(vertex) {}
+
+			inline const Vec3<T>& operator[](Ouint i) const { return vertex[i]->point(); }
+		};
+
+		// Fixed arity versions of the routines of the same name for polygons of N
+		// vertices, N = 0 for any number of vertices. Most polygons are triangles or
+		// quads, the routines above dispatch them to N = 3 or N = 4, where the loops
+		// have a constant trip count and Intersect keeps the distances on the stack.
+		template <Ouint NA>
+		static INTERSECT_TYPE   IntersectWith(const Polygon<T>& polygonA, const Polygon<T>& polygonB, Segment<T>& segmentA, Segment<T>& segmentB);
+		template <Ouint NA, Ouint NB>
+		static INTERSECT_TYPE   Intersect(const Polygon<T>& polygonA, const Polygon<T>& polygonB, Segment<T>& segmentA, Segment<T>& segmentB);
+		template <Ouint N>
+		INTERSECT_TYPE          DistancesFromVerticesToPolygonPlane(const Polygon<T>& polygon, T* distances, T intersection_tolerance) const;
+		template <Ouint N>
+		void                    SegmentWithIntesectionLine(const T* distancesA, Ray<T>& intesectionLine, Segment<T> &segmentA, T distance_tolerance) const;
+		template <Ouint N, Obool Extents>
+		void                    CalculatePlaneEquation();
+		template <Ouint N, class Points>
+		static RELPOS_STATUS    RelativePosition(const Points& points, Ouint size, const Vec3<T>& normal, const Vec3<T>& point);
+
 		std::vector<Vertex<T>*> _vertex;
 		Extent<T>               _extent;
 
@@ -21,7 +21,7 @@ namespace enterprise_manager {
 			}
 			for (Ouint i = 0; i < _vertex.size(); ++i) {
 				if (_vertex[i] != other._vertex[(i + offset) % _vertex.size()]) {
-					if (!_vertex[i]->_point.Equal(other._vertex[(i + offset) % _vertex.size()]->_point, _vertex[i]->unitTolerance)) {
+					if (!_vertex[i]->_point.Equal(other._vertex[(i + offset) % _vertex.size()]->_point, Context<T>::current().unitTolerance)) {
 						return false;
 					}
 				}
@@ -81,8 +81,7 @@ namespace enterprise_manager {
 
 		_index = index;
 
-		CalculateExtents();
-		CalculatePlaneEquation();
+		CalculatePlaneEquationAndExtents();
 	}
 
 	template <class T>
@@ -96,6 +95,16 @@ namespace enterprise_manager {
 		_d = original._d;
 	}
 
+	template <class T>
+	Polygon<T>::Polygon(const Polygon<T>& original, const std::vector<Vertex<T>*>& vertices)
+		: _vertex(vertices),
+		_extent(original._extent),
+		_normal(original._normal),
+		_d(original._d),
+		_index(original._index),
+		_area(original._area),
+		_isAreaCached(original._isAreaCached) {}
+
 	template <class T>
 	/* virtual */
 	Polygon<T>::~Polygon() {}
@@ -109,28 +118,86 @@ namespace enterprise_manager {
 	template <class T>
 	void
 		Polygon<T>::CalculatePlaneEquation() {
-			if (_vertex.size() == 3) {
+			switch (_vertex.size()) {
+			case 3:
 				CalculatePlaneEquation3();
-				return;
+				break;
+			case 4:
+				CalculatePlaneEquation<4, false>();
+				break;
+			default:
+				CalculatePlaneEquation<0, false>();
+				break;
+			}
+		}
+
+	template <class T>
+	void
+		Polygon<T>::CalculatePlaneEquationAndExtents() {
+			switch (_vertex.size()) {
+			case 3: {
+				const Vec3<T>& p0 = _vertex[0]->_point;
+				const Vec3<T>& p1 = _vertex[1]->_point;
+				const Vec3<T>& p2 = _vertex[2]->_point;
+				Vec3<T> max = p0;
+				Vec3<T> min = p0;
+				max.MaxComp(p1);
+				min.MinComp(p1);
+				max.MaxComp(p2);
+				min.MinComp(p2);
+				_extent.setMin(min);
+				_extent.setMax(max);
+				Vec3<T> v1 = (p1 - p0);
+				Vec3<T> v2 = (p2 - p1);
+				_normal = v1.Cross(v2);
+				_normal.Normalize();
+				_d = -(p0*_normal);
+				RefilCache();
+				break;
+			}
+			case 4:
+				CalculatePlaneEquation<4, true>();
+				break;
+			default:
+				CalculatePlaneEquation<0, true>();
+				break;
 			}
+		}
 
+	template <class T>
+	template <Ouint N, Obool Extents>
+	void
+		Polygon<T>::CalculatePlaneEquation() {
+			const Ouint count = N ? N : (Ouint)_vertex.size();
 			Ouint v0 = 0;
 			Ouint v1 = NULL;
 			Ouint v2 = NULL;
 
+			// The search for the farthest vertex visits all of them, so the extents
+			// are gathered on the way when asked for.
+			Vec3<T> max = _vertex[v0]->_point;
+			Vec3<T> min = _vertex[v0]->_point;
 			T distance = 0;
-			for (Ouint i = 1; i < _vertex.size(); i++) {
+			for (Ouint i = 1; i < count; i++) {
 				T alt = _vertex[v0]->_point.DistanceSqr(_vertex[i]->_point);
 				if (alt > distance) {
 					distance = alt;
 					v1 = i;
 				}
+				if (Extents) {
+					max.MaxComp(_vertex[i]->_point);
+					min.MinComp(_vertex[i]->_point);
+				}
+			}
+			if (Extents) {
+				_extent.setMin(min);
+				_extent.setMax(max);
 			}
 
 			distance = 0;
 			Vec3<T> lineDirection = (_vertex[v1]->_point - _vertex[v0]->_point);
 			lineDirection.Normalize();
-			for (Ouint i = 1; i < _vertex.size(); i++) {
+			for (Ouint i = 1; i < count; i++) {
 				if (i == v1)
 					continue;
 
@@ -187,7 +254,7 @@ namespace enterprise_manager {
 	Obool
 		Polygon<T>::IsPlanar() const {
 			for (Ouint i = 0; i < _vertex.size(); ++i) {
-				if (!enterprise_manager::EQ(_vertex[i]->point()*_normal + _d, T(0), Vertex<T>::tolerance)) {// * 5)) {
+				if (!enterprise_manager::EQ(_vertex[i]->point()*_normal + _d, T(0), Context<T>::current().tolerance)) {// * 5)) {
 					return false;
 				}
 			}
@@ -274,17 +341,57 @@ namespace enterprise_manager {
 	template <class T>
 	/*static*/ INTERSECT_TYPE
 		Polygon<T>::Intersect(const Polygon<T>& polygonA, const Polygon<T>& polygonB, Segment<T>& segmentA, Segment<T>& segmentB) {
-			T intersection_tolerance = Vertex<T>::tolerance; // / 2;
+			switch (polygonA._vertex.size()) {
+			case 3:
+				return IntersectWith<3>(polygonA, polygonB, segmentA, segmentB);
+			case 4:
+				return IntersectWith<4>(polygonA, polygonB, segmentA, segmentB);
+			default:
+				return IntersectWith<0>(polygonA, polygonB, segmentA, segmentB);
+			}
+		}
+
+	template <class T>
+	template <Ouint NA>
+	/*static*/ INTERSECT_TYPE
+		Polygon<T>::IntersectWith(const Polygon<T>& polygonA, const Polygon<T>& polygonB, Segment<T>& segmentA, Segment<T>& segmentB) {
+			switch (polygonB._vertex.size()) {
+			case 3:
+				return Intersect<NA, 3>(polygonA, polygonB, segmentA, segmentB);
+			case 4:
+				return Intersect<NA, 4>(polygonA, polygonB, segmentA, segmentB);
+			default:
+				return Intersect<NA, 0>(polygonA, polygonB, segmentA, segmentB);
+			}
+		}
+
+	template <class T>
+	template <Ouint NA, Ouint NB>
+	/*static*/ INTERSECT_TYPE
+		Polygon<T>::Intersect(const Polygon<T>& polygonA, const Polygon<T>& polygonB, Segment<T>& segmentA, Segment<T>& segmentB) {
+			Context<T>& context = Context<T>::current();
+			T intersection_tolerance = context.tolerance; // / 2;
 			//check each vertex in polygonA against the plane of polygonB
 
-			std::vector<T> distancesA(polygonA.vertex().size());
-			INTERSECT_TYPE intersection = polygonA.DistancesFromVerticesToPolygonPlane(polygonB, distancesA, intersection_tolerance);
+			//the distances of triangles and quads are kept on the stack
+			T fixedDistancesA[NA ? NA : 1];
+			T* distancesA = fixedDistancesA;
+			if (NA == 0) {
+				context.distancesA.resize(polygonA._vertex.size());
+				distancesA = &context.distancesA[0];
+			}
+			INTERSECT_TYPE intersection = polygonA.DistancesFromVerticesToPolygonPlane<NA>(polygonB, distancesA, intersection_tolerance);
 
 			if (intersection != INTERSECT)
 				return intersection;
 
-			std::vector<T> distancesB(polygonB.vertex().size());
-			intersection = polygonB.DistancesFromVerticesToPolygonPlane(polygonA, distancesB, intersection_tolerance);
+			T fixedDistancesB[NB ? NB : 1];
+			T* distancesB = fixedDistancesB;
+			if (NB == 0) {
+				context.distancesB.resize(polygonB._vertex.size());
+				distancesB = &context.distancesB[0];
+			}
+			intersection = polygonB.DistancesFromVerticesToPolygonPlane<NB>(polygonA, distancesB, intersection_tolerance);
 
 			if (intersection != INTERSECT)
 				return intersection;
@@ -299,11 +406,11 @@ namespace enterprise_manager {
 			Ray<T> intesectionLine;
 			CalcLineOfIntersection(polygonA, polygonB, intesectionLine);
 
-			//T local_tolerance = Vertex<T>::unitTolerance;
-			T distance_tolerance = Vertex<T>::tolerance;// / 1.5;
+			//T local_tolerance = Context<T>::current().unitTolerance;
+			T distance_tolerance = context.tolerance;// / 1.5;
 
-			polygonA.SegmentWithIntesectionLine(distancesA, intesectionLine, segmentA, distance_tolerance);
-			polygonB.SegmentWithIntesectionLine(distancesB, intesectionLine, segmentB, distance_tolerance);
+			polygonA.SegmentWithIntesectionLine<NA>(distancesA, intesectionLine, segmentA, distance_tolerance);
+			polygonB.SegmentWithIntesectionLine<NB>(distancesB, intesectionLine, segmentB, distance_tolerance);
 
 			// check if the intersection segments are overlapped
 			if (Segment<T>::Overlap(segmentA, segmentB))
@@ -315,12 +422,20 @@ namespace enterprise_manager {
 	template <class T>
 	enterprise_manager::INTERSECT_TYPE
 		Polygon<T>::DistancesFromVerticesToPolygonPlane(const Polygon<T>& polygon, std::vector<T>& distances, T intersection_tolerance) const {
+			return DistancesFromVerticesToPolygonPlane<0>(polygon, &distances[0], intersection_tolerance);
+		}
+
+	template <class T>
+	template <Ouint N>
+	enterprise_manager::INTERSECT_TYPE
+		Polygon<T>::DistancesFromVerticesToPolygonPlane(const Polygon<T>& polygon, T* distances, T intersection_tolerance) const {
 			Obool coplanar = true;
 			Obool hasPositiveDistances = false;
 			Obool hasNegativeDistances = false;
 			// calculate distances from A vertexes to plane of B and check if A is intersected by plane of B
-			for (Ouint i = 0; i < vertex().size(); ++i) {
-				const Vertex<T>& vertexA = *vertex()[i];
+			const Ouint count = N ? N : (Ouint)_vertex.size();
+			for (Ouint i = 0; i < count; ++i) {
+				const Vertex<T>& vertexA = *_vertex[i];
 				distances[i] = PlaneToPointDistance(polygon, vertexA.point());
 				if (!Equal(distances[i], T(0), intersection_tolerance)) {
 					// A vertex is not on the plane B
@@ -387,8 +502,16 @@ namespace enterprise_manager {
 	template <class T>
 	void
 		Polygon<T>::SegmentWithIntesectionLine(std::vector<T> &distancesFromVerticesToPlane, Ray<T>& intesectionRay, Segment<T> &segment, T distance_tolerance) const {
+			SegmentWithIntesectionLine<0>(&distancesFromVerticesToPlane[0], intesectionRay, segment, distance_tolerance);
+		}
+
+	template <class T>
+	template <Ouint N>
+	void
+		Polygon<T>::SegmentWithIntesectionLine(const T* distancesFromVerticesToPlane, Ray<T>& intesectionRay, Segment<T> &segment, T distance_tolerance) const {
+			const Ouint count = N ? N : (Ouint)_vertex.size();
 			// define segment of L where polygon A is intersected by B-plane 
-			for (Ouint i = 0; i < distancesFromVerticesToPlane.size(); ++i) {
+			for (Ouint i = 0; i < count; ++i) {
 				if (Equal(distancesFromVerticesToPlane[i], T(0), distance_tolerance)) {
 					// intersected in the vertex
 					T distance = intesectionRay.CalcVertexDistanceToPoint(*vertex()[i]);
@@ -401,7 +524,7 @@ namespace enterprise_manager {
 				}
 			}
 			//check edge [last]-[0]
-			Ouint last = (Ouint)distancesFromVerticesToPlane.size() - 1;
+			Ouint last = count - 1;
 			if (!Equal(distancesFromVerticesToPlane[0], T(0), distance_tolerance) && !Equal(distancesFromVerticesToPlane[last], T(0), distance_tolerance) && (distancesFromVerticesToPlane[0] > 0) != (distancesFromVerticesToPlane[last] > 0)) {
 				// intersected on edge [last]-[0]
 				T distance = intesectionRay.CalcVertexIntersectionDistanceToPoint(distancesFromVerticesToPlane[last], distancesFromVerticesToPlane[0], *vertex()[last], *vertex()[0]);
@@ -411,7 +534,7 @@ namespace enterprise_manager {
 				//search for vertex A closest to the L
 				T minDist = fabs(distancesFromVerticesToPlane[0]);
 				int minIndex = 0;
-				for (Ouint i = 1; i < distancesFromVerticesToPlane.size(); ++i) {
+				for (Ouint i = 1; i < count; ++i) {
 					if (fabs(distancesFromVerticesToPlane[i]) < minDist) {
 						minDist = fabs(distancesFromVerticesToPlane[i]);
 						minIndex = i;
@@ -455,25 +578,18 @@ namespace enterprise_manager {
 			shiftBaryCenter.Normalize();
 			//Shift must be not very small, because shift will not have effect and also shift not must be very large, 
 			//because new barycenter after shifting may be out of range. Two tolerance is optimal value.
-			return shiftBaryCenter * (Vertex<T>::tolerance * 2);
+			return shiftBaryCenter * (Context<T>::current().tolerance * 2);
 		}
 
 	template <class T>
 	RELPOS_STATUS
 		Polygon<T>::FindRelativePosition(const Vec3<T>& point) const {
-			//find a segment that contains a point 
-			if (EQ(point.DistanceToSegment(_vertex[0]->point(), _vertex[_vertex.size() - 1]->point()), T(0))) {
-				return BOUNDARY;
-			}
-			Ochar ix, iy;
-			FindProjectionAxes(_normal, ix, iy);
-
-			return _RelativePosition(point, ix, iy);
+			return RelativePosition(VertexPoints(_vertex), (Ouint)_vertex.size(), _normal, point);
 		}
 
 	template <class T>
-	inline void
-		Polygon<T>::FindProjectionAxes(const Vec3<T>& normal, Ochar& ix, Ochar& iy) const {
+	/*static*/ inline void
+		Polygon<T>::FindProjectionAxes(const Vec3<T>& normal, Ochar& ix, Ochar& iy) {
 			//find the two major axis for projection  
 			Ochar big = (fabs(normal[X]) > fabs(normal[Y])) ?
 				((fabs(normal[X]) > fabs(normal[Z])) ? 0 : 2) :
@@ -496,53 +612,76 @@ namespace enterprise_manager {
 		}
 
 	template <class T>
-	RELPOS_STATUS
-		Polygon<T>::_RelativePosition(const Vec3<T> &point, Ochar ix, Ochar iy) const {
-			Vertex<T>* firstIntersectedA = NULL;
-			Vertex<T>* lastIntersectedB = NULL;
-			Vertex<T>* A = NULL;
-			Vertex<T>* B = NULL;
+	template <class Points>
+	/*static*/ RELPOS_STATUS
+		Polygon<T>::RelativePosition(const Points& points, Ouint size, const Vec3<T>& normal, const Vec3<T>& point) {
+			switch (size) {
+			case 3:
+				return RelativePosition<3>(points, size, normal, point);
+			case 4:
+				return RelativePosition<4>(points, size, normal, point);
+			default:
+				return RelativePosition<0>(points, size, normal, point);
+			}
+		}
+
+	template <class T>
+	template <Ouint N, class Points>
+	/*static*/ RELPOS_STATUS
+		Polygon<T>::RelativePosition(const Points& points, Ouint size, const Vec3<T>& normal, const Vec3<T>& point) {
+			const Ouint count = N ? N : size;
+			//find a segment that contains a point 
+			if (EQ(point.DistanceToSegment(points[0], points[count - 1]), T(0))) {
+				return BOUNDARY;
+			}
+			Ochar ix, iy;
+			FindProjectionAxes(normal, ix, iy);
+
+			const Vec3<T>* firstIntersectedA = NULL;
+			const Vec3<T>* lastIntersectedB = NULL;
+			const Vec3<T>* A = NULL;
+			const Vec3<T>* B = NULL;
 
 			Obool c = false;
 			Obool vertexHit = false;
 
-			for (Ouint i = 1; i <= _vertex.size(); ++i) {
+			for (Ouint i = 1; i <= count; ++i) {
 
 				Ouint previous = i - 1;
-				Ouint current = (i == _vertex.size()) ? 0 : i;
+				Ouint current = (i == count) ? 0 : i;
 
-				if (EQ(point.DistanceToSegment(_vertex[previous]->point(), _vertex[current]->point()), T(0))) {
+				if (EQ(point.DistanceToSegment(points[previous], points[current]), T(0))) {
 					return BOUNDARY;
 				}
 
-				if (_vertex[previous]->point()[iy] == _vertex[current]->point()[iy])
+				if (points[previous][iy] == points[current][iy])
 					continue;
 
-				if (vertexHit && (A->point()[iy] > point[iy] == _vertex[current]->point()[iy] > point[iy])) {
+				if (vertexHit && ((*A)[iy] > point[iy] == points[current][iy] > point[iy])) {
 					//Common vertex B was hit. And previous segment and new segment are on the one side of the ray so roll back counter (we proved that it was not an intersection)
 					c = !c;
 					vertexHit = false;
 				}
 
-				A = _vertex[previous];
-				B = _vertex[current];
+				A = &points[previous];
+				B = &points[current];
 
-				bool isBetweenWithRespectToY = (B->point()[iy] > point[iy] != A->point()[iy] > point[iy]);
-				bool notFullyOnThRightSide = !(point[ix] > A->point()[ix] && point[ix] > B->point()[ix]);
+				bool isBetweenWithRespectToY = ((*B)[iy] > point[iy] != (*A)[iy] > point[iy]);
+				bool notFullyOnThRightSide = !(point[ix] > (*A)[ix] && point[ix] > (*B)[ix]);
 
 				if (isBetweenWithRespectToY && notFullyOnThRightSide) {
-					T k = A->point()[ix] + (point[iy] - A->point()[iy])*(B->point()[ix] - A->point()[ix]) / (B->point()[iy] - A->point()[iy]);
+					T k = (*A)[ix] + (point[iy] - (*A)[iy])*((*B)[ix] - (*A)[ix]) / ((*B)[iy] - (*A)[iy]);
 
-					bool isRayIntersect = point[ix] + Vertex<T>::tolerance < k;
+					bool isRayIntersect = point[ix] + Context<T>::current().tolerance < k;
 
 					if (!isRayIntersect) continue;
 
 					c = !c; //count as intersection until we proved otherwise
-					if (B->point()[iy] == point[iy]) {
+					if ((*B)[iy] == point[iy]) {
 						vertexHit = true;
 						lastIntersectedB = B;
 					}
-					if (A->point()[iy] == point[iy] && firstIntersectedA == NULL) {
+					if ((*A)[iy] == point[iy] && firstIntersectedA == NULL) {
 						firstIntersectedA = A;
 					}
 				}
@@ -550,7 +689,7 @@ namespace enterprise_manager {
 
 			// if the last meaning edge was hit at the vertex B we need to compare it with first edge that was hit at vertex A
 			// This case works when we have a lot of 'skipped'(i.e. parallel to ray) edges between last edge that was in B and first edged that was hit in A
-			if (vertexHit && firstIntersectedA && lastIntersectedB && (firstIntersectedA->point()[iy] > point[iy] == lastIntersectedB->point()[iy] > point[iy])) {
+			if (vertexHit && firstIntersectedA && lastIntersectedB && ((*firstIntersectedA)[iy] > point[iy] == (*lastIntersectedB)[iy] > point[iy])) {
 				c = !c;
 			}
 
@@ -622,7 +761,7 @@ namespace enterprise_manager {
 	void
 		Polygon<T>::CheckCollinear() { //remove collinear sequential points 
 			if (_vertex.size() > 3) {
-				T tolerance2 = Vertex<T>::tolerance * Vertex<T>::tolerance;
+				T tolerance2 = Context<T>::current().tolerance * Context<T>::current().tolerance;
 				Vertex<T> *v0, *v1;
 				int index1 = _vertex.size() - 1;
 				v1 = _vertex[index1];
@@ -701,10 +840,10 @@ namespace enterprise_manager {
 	template <class T>
 	Obool
 		Polygon<T>::IsCoplanar(const Polygon<T>* other) {
-			if (!enterprise_manager::EQ(this->_d, other->_d, Vertex<T>::tolerance))// * 5))
+			if (!enterprise_manager::EQ(this->_d, other->_d, Context<T>::current().tolerance))// * 5))
 				return false;
 
-			if (!this->_normal.Equal(other->_normal, Vertex<T>::tolerance))
+			if (!this->_normal.Equal(other->_normal, Context<T>::current().tolerance))
 				return false;
 
 			return true;
@@ -745,7 +884,7 @@ namespace enterprise_manager {
 				Vertex<T>* v1 = _vertex[i];
 				for (Ouint j = 0; j < poly->_vertex.size(); j++) {
 					Vertex<T>* v = poly->_vertex[j];
-					if (v->_point.Equal(v0->_point, Vertex<T>::tolerance) || v->_point.Equal(v1->_point, Vertex<T>::tolerance))
+					if (v->_point.Equal(v0->_point, Context<T>::current().tolerance) || v->_point.Equal(v1->_point, Context<T>::current().tolerance))
 						continue;
 					if (EQ(v->_point.DistanceToSegment(v0->_point, v1->_point), T(0))) {
 						_vertex.insert(_vertex.begin() + i, v);
@@ -793,9 +932,9 @@ namespace enterprise_manager {
 			shiftToMidle = halfMinSide - barycenter;
 			T lengthMindle = shiftToMidle.Length();
 			//shift to boundary of minimum side
-			//if ((Vertex<T>::tolerance*2) < (lengthMindle / 2))
-			return (shiftToMidle.Normalize() * (lengthMindle - Vertex<T>::tolerance * 2));
-			//return shiftToMidle.Normalize() * Vertex<T>::tolerance*2;
+			//if ((Context<T>::current().tolerance*2) < (lengthMindle / 2))
+			return (shiftToMidle.Normalize() * (lengthMindle - Context<T>::current().tolerance * 2));
+			//return shiftToMidle.Normalize() * Context<T>::current().tolerance*2;
 		}
 
 	//Shift barycenter on shiftForBaryCenter.
@@ -853,7 +992,7 @@ namespace enterprise_manager {
 	Obool
 		Polygon<T>::isHasVertex(const Vertex<T> &vertexB, Ouint *indexEqualVertex) const {
 			for (Ouint i = 0; i < _vertex.size(); ++i) {
-				if (_vertex[i]->point().Equal(vertexB.point(), Vertex<T>::tolerance)) {
+				if (_vertex[i]->point().Equal(vertexB.point(), Context<T>::current().tolerance)) {
 					if (indexEqualVertex)
 						*indexEqualVertex = i;
 					return true;
@@ -866,8 +1005,8 @@ namespace enterprise_manager {
 	Obool
 		Polygon<T>::IsMeaning() const {
 			T val = abs(Area());
-			T eps = Vertex<T>::epsilonValue;
-			if (val - Vertex<T>::tolerance <= Vertex<T>::epsilonValue)
+			const Context<T>& context = Context<T>::current();
+			if (val - context.tolerance <= context.epsilonValue)
 				return false;
 			return true;
 		}
@@ -169,13 +169,13 @@ namespace enterprise_manager {
 			}
 
 			if (_startDistance < _endDistance) {
-				if (Lesser(maxB, _endDistance, Vertex<T>::tolerance)) {// *2)) {
+				if (Lesser(maxB, _endDistance, Context<T>::current().tolerance)) {// *2)) {
 					_endDistance = maxB;
 					_endpointType = _midpointType;
 					if (_midpointType == EDGE && (_endIndex == polygonA.NextIndex(_startIndex)))
 						_endIndex = _startIndex;
 				}
-				if (Greater(minB, _startDistance, Vertex<T>::tolerance)) {// *2)) {
+				if (Greater(minB, _startDistance, Context<T>::current().tolerance)) {// *2)) {
 					_startDistance = minB;
 					_startpointType = _midpointType;
 					if (_midpointType == EDGE && (_endIndex != polygonA.NextIndex(_startIndex)))
@@ -183,13 +183,13 @@ namespace enterprise_manager {
 				}
 			}
 			else {
-				if (Lesser(maxB, _startDistance, Vertex<T>::tolerance)) {// *2)) {
+				if (Lesser(maxB, _startDistance, Context<T>::current().tolerance)) {// *2)) {
 					_startDistance = maxB;
 					_startpointType = _midpointType;
 					if (_midpointType == EDGE && (_endIndex != polygonA.NextIndex(_startIndex)))
 						_startIndex = _endIndex;
 				}
-				if (Greater(minB, _endDistance, Vertex<T>::tolerance)) {// *2)) {
+				if (Greater(minB, _endDistance, Context<T>::current().tolerance)) {// *2)) {
 					_endDistance = minB;
 					_endpointType = _midpointType;
 					if (_midpointType == EDGE && (_endIndex == polygonA.NextIndex(_startIndex)))
@@ -0,0 +1,116 @@
+#include "config.h"
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+namespace enterprise_manager {
+
+	// The sink of the events, guarded by traceMutex.
+	static std::mutex traceMutex;
+	static std::ofstream traceFile;
+	static Obool traceFirstEvent = true;
+	static Trace::Callback traceCallback = NULL;
+	static void* traceData = NULL;
+
+	// Clock ticks at Start.
+	static std::atomic<Oint64> traceStart(0);
+
+	// The threads are numbered in the order of their first event.
+	static std::atomic<Ouint> traceThreadCount(0);
+	static O_THREAD_LOCAL Ouint traceThread = 0;
+
+	/* static */ std::atomic<Obool>
+		Trace::_enabled(false);
+
+	/* static */ Obool
+		Trace::Start(const std::string& fileName) {
+			std::lock_guard<std::mutex> lock(traceMutex);
+			if (traceFile.is_open())
+				traceFile.close();
+			traceFile.open(fileName.c_str(), std::ios::out | std::ios::trunc);
+			if (!traceFile.is_open()) {
+				_enabled = traceCallback != NULL;
+				return false;
+			}
+			traceFile << "[";
+			traceFirstEvent = true;
+			traceCallback = NULL;
+			traceData = NULL;
+			traceStart = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+			_enabled = true;
+			return true;
+		}
+
+	/* static */ void
+		Trace::Start(Callback callback, void* data) {
+			std::lock_guard<std::mutex> lock(traceMutex);
+			if (traceFile.is_open()) {
+				traceFile << "\n]\n";
+				traceFile.close();
+			}
+			traceCallback = callback;
+			traceData = data;
+			traceStart = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+			_enabled = callback != NULL;
+		}
+
+	/* static */ void
+		Trace::Stop() {
+			std::lock_guard<std::mutex> lock(traceMutex);
+			_enabled = false;
+			if (traceFile.is_open()) {
+				traceFile << "\n]\n";
+				traceFile.close();
+			}
+			traceCallback = NULL;
+			traceData = NULL;
+		}
+
+	/* static */ Odouble
+		Trace::now() {
+			typedef std::chrono::high_resolution_clock Clock;
+			Clock::duration elapsed(Clock::now().time_since_epoch().count() - traceStart);
+			return std::chrono::duration<Odouble, std::micro>(elapsed).count();
+		}
+
+	/* static */ void
+		Trace::Complete(const char* name, Odouble start, Odouble duration) {
+			if (traceThread == 0)
+				traceThread = ++traceThreadCount;
+			char event[256];
+			sprintf(event, "{\"name\":\"%.160s\",\"cat\":\"csg\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}", name, start, duration, traceThread);
+
+			//the callback is called outside the lock, so the threads do not wait for each other's callbacks
+			Callback callback = NULL;
+			void* data = NULL;
+			{
+				std::lock_guard<std::mutex> lock(traceMutex);
+				if (!_enabled)
+					return;
+				if (traceCallback == NULL) {
+					traceFile << (traceFirstEvent ? "\n" : ",\n") << event;
+					traceFirstEvent = false;
+					return;
+				}
+				callback = traceCallback;
+				data = traceData;
+			}
+			callback(event, data);
+		}
+
+	TraceScope::TraceScope(const char* name)
+		: _name(Trace::enabled() ? name : NULL),
+		_start(0) {
+		if (_name)
+			_start = Trace::now();
+	}
+
+	/* virtual */
+	TraceScope::~TraceScope() {
+		if (_name && Trace::enabled())
+			Trace::Complete(_name, _start, Trace::now() - _start);
+	}
+
+} // namespace enterprise_manager
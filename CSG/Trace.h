@@ -0,0 +1,73 @@
+#ifndef CSG_TRACE_H
+#define CSG_TRACE_H
+
+#include "config.h"
+#include <atomic>
+#include <string>
+
+namespace enterprise_manager {
+
+	// The class Trace records the trace markers of the operations as Chrome trace
+	// events, which chrome://tracing and Perfetto show on a timeline with one row
+	// per thread. The markers are only built with O_TRACE, see config.h, and are
+	// only recorded between Start and Stop.
+	class Trace {
+	public:
+		// Called with each event as a JSON object.
+		typedef void (*Callback)(const std::string& event, void* data);
+
+		// Write the events to the file as a JSON array. Returns false if the file
+		// cannot be opened. The file is complete once Stop is called.
+		static Obool            Start(const std::string& fileName);
+		// Pass the events to the callback, from the threads running the operations.
+		// The callback runs without a lock held, on several threads at once, and may
+		// call Stop. It may still get the events of the threads inside Complete
+		// while Stop runs.
+		static void             Start(Callback callback, void* data);
+		static void             Stop();
+
+		static inline Obool     enabled();
+
+		// Microseconds since Start.
+		static Odouble          now();
+
+		// Record an event of the calling thread that began at start and lasted duration
+		// microseconds. The name is written as it is, without escaping.
+		static void             Complete(const char* name, Odouble start, Odouble duration);
+
+	private:
+		static std::atomic<Obool> _enabled;
+	};
+
+	// The class TraceScope records an event from its construction to its
+	// destruction. Use it through O_TRACE_SCOPE.
+	class TraceScope {
+	public:
+		explicit TraceScope(const char* name);
+		virtual                 ~TraceScope();
+
+	private:
+		TraceScope(const TraceScope&);
+		TraceScope&             operator=(const TraceScope&);
+
+		const char*             _name;
+		Odouble                 _start;
+	};
+
+	inline Obool
+		Trace::enabled() {
+			return _enabled;
+		}
+
+} // namespace enterprise_manager
+
+// Record the rest of the enclosing block as an event with the name.
+#ifdef O_TRACE
+#define O_TRACE_CONCAT2(a, b) a##b
+#define O_TRACE_CONCAT(a, b) O_TRACE_CONCAT2(a, b)
+#define O_TRACE_SCOPE(name) enterprise_manager::TraceScope O_TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define O_TRACE_SCOPE(name)
+#endif
+
+#endif // CSG_TRACE_H
@@ -1,17 +1,15 @@
 #include "config.h"
 #include "TriangulatedSurface.h"
-#include "Vertex.h"
+#include "Context.h"
 
 namespace enterprise_manager {
 
-	/* static*/ CSGReal
-		TriangulatedSurface::toleranceSquared = Vertex<CSGReal>::unitTolerance*Vertex<CSGReal>::unitTolerance;
-
 	/* static */ void
 		TriangulatedSurface::Weld(const std::vector<Vec3<CSGReal> >& coords, std::vector<Oint>& indices) {
+			CSGReal tolerance = Context<CSGReal>::current().tolerance;
 			for (Oint i = 0; i < coords.size(); ++i) {
 				for (Oint j = 0; j < i; ++j) {
-					if (coords[i].DistanceSqr(coords[j]) < Vertex<CSGReal>::tolerance*Vertex<CSGReal>::tolerance) {
+					if (coords[i].DistanceSqr(coords[j]) < tolerance*tolerance) {
 						//coords.erase(coords.begin() + i, coords.begin() + i +1);
 						Oint indicesSize = static_cast<Oint>(indices.size());
 						for (Oint k = 0; k < indicesSize; ++k) {
@@ -28,7 +26,8 @@ namespace enterprise_manager {
 			Vec3<CSGReal> ab = b - a;
 			Vec3<CSGReal> ac = c - a;
 
-			if (ab.Cross(ac).LengthSqr() > toleranceSquared) {
+			CSGReal unitTolerance = Context<CSGReal>::current().unitTolerance;
+			if (ab.Cross(ac).LengthSqr() > unitTolerance*unitTolerance) {
 				// the area of the parallelogram spanned by (ab, ac) is bigger than the tolerance so the triangle is valid
 				return true;
 			}
@@ -38,7 +37,6 @@ namespace enterprise_manager {
 
 	/* static */ void
 		TriangulatedSurface::VerifyAndRepairTopology(const std::vector<Vec3<CSGReal> >& coords, std::vector<Oint>& indices) {
-			CSGReal toleranceSquared = Vertex<CSGReal>::unitTolerance*Vertex<CSGReal>::unitTolerance;
 			for (Ouint i = 0; i < indices.size();) {
 				Ouint ia = indices[i];
 				Ouint ib = indices[i + 1];
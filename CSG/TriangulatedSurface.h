@@ -8,12 +8,11 @@ namespace enterprise_manager {
 
 	class TriangulatedSurface {
 	public:
+		// The tolerances are the ones of the current context, see Context.
 		static void Weld(const std::vector<Vec3<CSGReal> >& coords, std::vector<Oint>& indices);
 
 		static void VerifyAndRepairTopology(const std::vector<Vec3<CSGReal> >& coords, std::vector<Oint>& indices);
 		static Obool IsValidTriangle(const Vec3<CSGReal>& a, const Vec3<CSGReal>& b, const Vec3<CSGReal>& c);
-	private:
-		static CSGReal toleranceSquared;
 	};
 
 } // namespace enterprise_manager
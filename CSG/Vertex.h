@@ -3,6 +3,7 @@
 
 #include "config.h"
 #include "DataTypes/Vec3.h"
+#include "Context.h"
 #include <vector>
 #include <limits>
 
@@ -37,11 +38,6 @@ namespace enterprise_manager {
 	public:
 		inline const Vec3<T>&   point() const;
 
-		// Static template variables to keep tolerances
-		static T                tolerance;
-		static T                unitTolerance;
-		static T                epsilonValue;
-
 		inline void             setStatus(RELPOS_STATUS status);
 		inline RELPOS_STATUS    status() const;
 
@@ -83,24 +79,24 @@ namespace enterprise_manager {
 		static SIDE_TRIANGLE    MaxSectionAtVertex(const Vertex<T>* A, const Vertex<T>* B, const Vertex<T>* C);
 	};
 
-	template <typename T> Obool Equal(T a, T b) { return (abs(a - b) < Vertex<T>::tolerance); };
-	template <typename T> Obool Greater(T a, T b) { return (a > (b + Vertex<T>::tolerance)); };
-	template <typename T> Obool Lesser(T a, T b) { return (a < (b - Vertex<T>::tolerance)); };
+	template <typename T> Obool Equal(T a, T b) { return (abs(a - b) < Context<T>::current().tolerance); };
+	template <typename T> Obool Greater(T a, T b) { return (a > (b + Context<T>::current().tolerance)); };
+	template <typename T> Obool Lesser(T a, T b) { return (a < (b - Context<T>::current().tolerance)); };
 
 	template <typename T> Obool Equal(T a, T b, T tolerance) { return (abs(a - b) < tolerance); };
 	template <typename T> Obool Greater(T a, T b, T tolerance) { return (a > (b + tolerance)); };
 	template <typename T> Obool Lesser(T a, T b, T tolerance) { return (a < (b - tolerance)); };
 
-	template <typename T> Obool UnitEqual(T a, T b) { return (abs(a - b) < Vertex<T>::unitTolerance); }
-	template <typename T> Obool UnitGreater(T a, T b) { return (a > (b + Vertex<T>::unitTolerance)); };
-	template <typename T> Obool UnitLesser(T a, T b) { return (a < (b - Vertex<T>::unitTolerance)); };
+	template <typename T> Obool UnitEqual(T a, T b) { return (abs(a - b) < Context<T>::current().unitTolerance); }
+	template <typename T> Obool UnitGreater(T a, T b) { return (a > (b + Context<T>::current().unitTolerance)); };
+	template <typename T> Obool UnitLesser(T a, T b) { return (a < (b - Context<T>::current().unitTolerance)); };
 
-	template <typename T> Obool GT(T a, T b) { return (a >(b + Vertex<T>::tolerance)); };
-	template <typename T> Obool GE(T a, T b) { return (a >= (b - Vertex<T>::tolerance)); };
-	template <typename T> Obool EQ(T a, T b) { return (abs(a - b) <= Vertex<T>::tolerance); };
-	template <typename T> Obool NQ(T a, T b) { return (abs(a - b) > Vertex<T>::tolerance); };
-	template <typename T> Obool LE(T a, T b) { return (a <= (b + Vertex<T>::tolerance)); };
-	template <typename T> Obool LT(T a, T b) { return (a < (b - Vertex<T>::tolerance)); };
+	template <typename T> Obool GT(T a, T b) { return (a >(b + Context<T>::current().tolerance)); };
+	template <typename T> Obool GE(T a, T b) { return (a >= (b - Context<T>::current().tolerance)); };
+	template <typename T> Obool EQ(T a, T b) { return (abs(a - b) <= Context<T>::current().tolerance); };
+	template <typename T> Obool NQ(T a, T b) { return (abs(a - b) > Context<T>::current().tolerance); };
+	template <typename T> Obool LE(T a, T b) { return (a <= (b + Context<T>::current().tolerance)); };
+	template <typename T> Obool LT(T a, T b) { return (a < (b - Context<T>::current().tolerance)); };
 
 	template <typename T> Obool GT(T a, T b, T tolerance) { return (a >(b + tolerance)); };
 	template <typename T> Obool GE(T a, T b, T tolerance) { return (a > (b - tolerance)); };
@@ -109,19 +105,6 @@ namespace enterprise_manager {
 	template <typename T> Obool LE(T a, T b, T tolerance) { return (a < (b - tolerance)); };
 	template <typename T> Obool LT(T a, T b, T tolerance) { return (a < (b + tolerance)); };
 
-	template <>
-	/*static*/ Odouble Vertex<Odouble>::tolerance = 0.1 / 1000;
-	template <>
-	/*static*/ Odouble Vertex<Odouble>::unitTolerance = 0.0001;
-	template<>
-	/*static*/ Odouble Vertex<Odouble>::epsilonValue = std::numeric_limits<Odouble>::epsilon();
-
-	template <>
-	/*static*/ Ofloat Vertex<Ofloat>::tolerance = 0.1f / 1000.0f;
-	template <>
-	/*static*/ Ofloat Vertex<Ofloat>::unitTolerance = 0.0001f;
-	template<>
-	/*static*/ Ofloat Vertex<Ofloat>::epsilonValue = std::numeric_limits<Ofloat>::epsilon();
 } // namespace enterprise_manager
 
 #include "Vertex.inl"
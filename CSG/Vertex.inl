@@ -70,17 +70,24 @@ namespace enterprise_manager {
 			Vec3<T> dir2 = _point - point;
 
 			Vec3<T> v = ((dir * dir2) * dir) - dir2;
-			return (v.LengthSqr() < Vertex<T>::tolerance * Vertex<T>::tolerance);
+			return (v.LengthSqr() < Context<T>::current().tolerance * Context<T>::current().tolerance);
 		}
 
 	template <typename T>
 	void
 		Vertex<T>::MarkConnectedVertices(RELPOS_STATUS status) {
+			//walk the connected vertices with an explicit stack, large meshes would overflow the call stack
+			std::vector<Vertex<T>*> stack;
 			_status = status;
-			for (Ouint i = 0; i < _adjacentVertex.size(); ++i) {
-				if (_adjacentVertex[i]->status() == UNKNOWN) {
-					_adjacentVertex[i]->setStatus(status);
-					_adjacentVertex[i]->MarkConnectedVertices(status);
+			stack.push_back(this);
+			while (!stack.empty()) {
+				Vertex<T>* vertex = stack.back();
+				stack.pop_back();
+				for (Ouint i = 0; i < vertex->_adjacentVertex.size(); ++i) {
+					if (vertex->_adjacentVertex[i]->status() == UNKNOWN) {
+						vertex->_adjacentVertex[i]->setStatus(status);
+						stack.push_back(vertex->_adjacentVertex[i]);
+					}
 				}
 			}
 		}
@@ -117,15 +124,15 @@ namespace enterprise_manager {
 	template <class T>
 	/* static */ Obool
 		Vertex<T>::IsAltCollinear(const Vertex<T>* A, const Vertex<T>* B, const Vertex<T>* C) {
-			if (A->point().Equal(B->point(), Vertex<T>::tolerance) ||
-				A->point().Equal(C->point(), Vertex<T>::tolerance) ||
-				B->point().Equal(C->point(), Vertex<T>::tolerance))
+			if (A->point().Equal(B->point(), Context<T>::current().tolerance) ||
+				A->point().Equal(C->point(), Context<T>::current().tolerance) ||
+				B->point().Equal(C->point(), Context<T>::current().tolerance))
 				return true;
 			Vec3<T> b_a = B->point() - A->point();
 			b_a.Normalize();
 			Vec3<T> c_a = C->point() - A->point();
 			Vec3<T> c_height = c_a - (c_a * b_a) * b_a;
-			return EQ(c_height * c_height, T(0), Vertex<T>::tolerance*Vertex<T>::tolerance);
+			return EQ(c_height * c_height, T(0), Context<T>::current().tolerance*Context<T>::current().tolerance);
 		}
 
 } // namespace enterprise_manager
@@ -0,0 +1,55 @@
+#ifndef CSG_VERTEXGRID_H
+#define CSG_VERTEXGRID_H
+
+#include "Vertex.h"
+#include <vector>
+
+namespace enterprise_manager {
+
+	// The class VertexGrid is a spatial hash of the vertices of an Object. The
+	// vertices are sorted into cubic cells sized from the tolerance, so finding
+	// an existing vertex at a point only has to look at the cells around the point.
+	template <class T> class VertexGrid {
+	public:
+		VertexGrid();
+		virtual                 ~VertexGrid();
+
+		// Add the vertices which are not in the grid yet. The vertices are expected
+		// to be appended to the end of the list only. If the tolerance has changed,
+		// or the list is shorter than the grid, the grid is rebuilt.
+		void                    Update(const std::vector<Vertex<T>*>& vertices, T tolerance);
+
+		// Remove all vertices. Must be called when vertices are removed, reordered or moved.
+		void                    Clear();
+
+		// Find the vertex with the lowest index within the tolerance of the point.
+		// Returns -1 if there is no such vertex.
+		Oint                    Find(const std::vector<Vertex<T>*>& vertices, const Vec3<T>& point) const;
+
+		inline Ouint            size() const;
+
+	private:
+		struct Entry {
+			Oint64              cell[3];
+			Oint                vertex;
+			Oint                next;
+		};
+
+		void                    Insert(Oint vertex, const Vec3<T>& point);
+		void                    Rehash(Ouint bucketCount);
+
+		inline Oint64           CellIndex(T coordinate) const;
+		static inline Ouint     Hash(Oint64 x, Oint64 y, Oint64 z);
+
+		// Head of the entry chain for each bucket, -1 if empty. The number of buckets is a power of two.
+		std::vector<Oint>       _bucket;
+		std::vector<Entry>      _entry;
+		T                       _tolerance;
+		T                       _cellSize;
+	};
+
+} // namespace enterprise_manager
+
+#include "VertexGrid.inl"
+
+#endif // CSG_VERTEXGRID_H
@@ -0,0 +1,119 @@
+namespace enterprise_manager {
+
+	template <class T>
+	VertexGrid<T>::VertexGrid()
+		: _tolerance(0),
+		_cellSize(1) {}
+
+	template <class T>
+	/* virtual */
+	VertexGrid<T>::~VertexGrid() {}
+
+	template <class T>
+	inline Ouint
+		VertexGrid<T>::size() const {
+			return (Ouint)_entry.size();
+		}
+
+	template <class T>
+	void
+		VertexGrid<T>::Clear() {
+			_bucket.clear();
+			_entry.clear();
+		}
+
+	template <class T>
+	inline Oint64
+		VertexGrid<T>::CellIndex(T coordinate) const {
+			return (Oint64)floor(coordinate / _cellSize);
+		}
+
+	template <class T>
+	/* static */ inline Ouint
+		VertexGrid<T>::Hash(Oint64 x, Oint64 y, Oint64 z) {
+			Ouint64 h = (Ouint64)x * 73856093ULL;
+			h ^= (Ouint64)y * 19349663ULL;
+			h ^= (Ouint64)z * 83492791ULL;
+			return (Ouint)(h ^ (h >> 32));
+		}
+
+	template <class T>
+	void
+		VertexGrid<T>::Update(const std::vector<Vertex<T>*>& vertices, T tolerance) {
+			if (tolerance != _tolerance || vertices.size() < _entry.size()) {
+				Clear();
+				_tolerance = tolerance;
+				// A cell at least twice the tolerance means a point never has to look
+				// further than the neighbour cell on each axis.
+				_cellSize = (tolerance > 0) ? 2 * tolerance : T(1);
+			}
+			if (_bucket.size() < 2 * vertices.size())
+				Rehash(O_MAX(2 * (Ouint)vertices.size(), 64u));
+			for (Ouint i = (Ouint)_entry.size(); i < vertices.size(); ++i) {
+				Insert(i, vertices[i]->point());
+			}
+		}
+
+	template <class T>
+	void
+		VertexGrid<T>::Rehash(Ouint bucketCount) {
+			Ouint size = 1;
+			while (size < bucketCount)
+				size <<= 1;
+			_bucket.assign(size, -1);
+			for (Ouint i = 0; i < _entry.size(); ++i) {
+				Entry& entry = _entry[i];
+				Ouint bucket = Hash(entry.cell[X], entry.cell[Y], entry.cell[Z]) & (size - 1);
+				entry.next = _bucket[bucket];
+				_bucket[bucket] = i;
+			}
+		}
+
+	template <class T>
+	void
+		VertexGrid<T>::Insert(Oint vertex, const Vec3<T>& point) {
+			Entry entry;
+			entry.cell[X] = CellIndex(point[X]);
+			entry.cell[Y] = CellIndex(point[Y]);
+			entry.cell[Z] = CellIndex(point[Z]);
+			entry.vertex = vertex;
+			Ouint bucket = Hash(entry.cell[X], entry.cell[Y], entry.cell[Z]) & ((Ouint)_bucket.size() - 1);
+			entry.next = _bucket[bucket];
+			_bucket[bucket] = (Oint)_entry.size();
+			_entry.push_back(entry);
+		}
+
+	template <class T>
+	Oint
+		VertexGrid<T>::Find(const std::vector<Vertex<T>*>& vertices, const Vec3<T>& point) const {
+			if (_entry.empty())
+				return -1;
+
+			Oint64 min[3], max[3];
+			for (Oint axis = X; axis <= Z; ++axis) {
+				min[axis] = CellIndex(point[axis] - _tolerance);
+				max[axis] = CellIndex(point[axis] + _tolerance);
+			}
+
+			//several vertices may be within the tolerance, return the first one as a linear search would
+			Oint found = -1;
+			Ouint mask = (Ouint)_bucket.size() - 1;
+			for (Oint64 x = min[X]; x <= max[X]; ++x) {
+				for (Oint64 y = min[Y]; y <= max[Y]; ++y) {
+					for (Oint64 z = min[Z]; z <= max[Z]; ++z) {
+						for (Oint i = _bucket[Hash(x, y, z) & mask]; i != -1; i = _entry[i].next) {
+							const Entry& entry = _entry[i];
+							if (entry.cell[X] != x || entry.cell[Y] != y || entry.cell[Z] != z)
+								continue;
+							if (found != -1 && entry.vertex > found)
+								continue;
+							if (vertices[entry.vertex]->point().Equal(point, _tolerance))
+								found = entry.vertex;
+						}
+					}
+				}
+			}
+			return found;
+		}
+
+} // namespace enterprise_manager
@@ -10,6 +10,30 @@
 #define WIN32_LEAN_AND_MEAN
 #endif 
 
+// Thread local storage. Visual C++ before 2015 has no thread_local, its
+// __declspec(thread) is limited to plain data.
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define O_THREAD_LOCAL __declspec(thread)
+#else
+#define O_THREAD_LOCAL thread_local
+#endif
+
+// Vector instructions used by the batched kernels, see PlaneTable and
+// Matrix4::TransformPoints. SSE2 is part of x64 and the default of 32 bit
+// Visual C++ since 2012, AVX2 needs /arch:AVX2.
+// Define O_NO_SIMD to build the scalar kernels only.
+#ifndef O_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define O_SIMD_SSE2
+#endif
+#if defined(__AVX2__)
+#define O_SIMD_AVX2
+#endif
+#endif
+
+// Define O_TRACE to build the trace markers of the operations, see Trace.
+// Without it O_TRACE_SCOPE expands to nothing.
+
 typedef size_t Osize; //size types for everything but fields (32/64 bit)
 typedef unsigned short Ofsize; //size type for fields
 